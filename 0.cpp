@@ -1,4 +1,21 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "advalgo/parse.hpp"
+#include "advalgo/square.hpp"
 
 /*
 
@@ -25,39 +42,468 @@
 Вы можете выводить YES и NO в любом регистре (например, строки yEs, yes, Yes и YES будут распознаны
 как положительный ответ).
 
+## Описание решения
+Строка нечетной длины квадратной быть не может. Для строки четной длины сравниваем первую половину
+со второй через memcmp: библиотечная реализация сравнивает сразу по 16-64 байта векторными
+инструкциями, а не по одному символу.
+
+## Пакетная проверка
+Режим `--batch` проверяет произвольное количество записей произвольной длины: вход - записи,
+разделенные переводом строки, без числа t в начале; пустые строки пропускаются. Вход считывается в
+память целиком, запись - это string_view прямо в буфере, без копирования в отдельные строки.
+
+Буфер делится на блоки около 8 МБ по границам строк. Блоки обрабатываются раундами по THREADS штук:
+каждый поток отвечает на записи своего блока в собственный буфер, после чего буферы в исходном
+порядке отдаются буферизованному писателю (один fwrite на 64 КБ вывода). Так вывод совпадает с
+последовательной версией, а память под ответы ограничена размером раунда. Количество потоков по
+умолчанию равно std::thread::hardware_concurrency(), его можно задать аргументом `--threads K`.
+
+`--bench` печатает записей в секунду и ГБ/с для коротких (до 100 символов) и длинных (от 1 МБ)
+записей: для посимвольного сравнения и для memcmp при числе потоков от 1 до количества ядер.
+
+## Квадраты подстрок
+Режим `--substrings` отвечает на много запросов "является ли квадратом s[l..r]" к одной длинной
+строке. Формат ввода: в первой строке s, во второй - количество запросов Q, далее Q строк "l r"
+(нумерация с 1, границы включительно); для каждого запроса выводится YES или NO. Пустые строки
+пропускаются, а все, что идет после Q запросов, не читается.
+
+Для s строятся префиксные полиномиальные хеши по модулю 2^61 - 1 со случайным основанием и степени
+основания. Хеш подстроки s[l, r) - prefix[r] - prefix[l] * base^(r - l), так что запрос - сравнение
+хешей двух половин за O(1). Умножение по модулю 2^61 - 1 - одно 128-битное произведение и сложение
+старшей и младшей частей без деления. Вероятность коллизии для одного запроса - порядка n / 2^61.
+
+Запросы разбираются и отвечаются теми же блоками и потоками, что и в режиме `--batch`. Таблицы
+хешей занимают 16 байт на символ и не помещаются в кеш, поэтому запросы обрабатываются пачками по
+64: сначала пачка разбирается и для каждого запроса запрашиваются из памяти нужные элементы
+таблиц, затем даются ответы.
+
+`--substrings --bench` строит индекс для n = 10^7 и отвечает на Q = 10^7 запросов: напрямую, через
+разбор текстового потока и для сравнения memcmp половин на части запросов.
+
+## Асимптотика решения
+Время: O(суммарной длины строк), в режиме `--substrings` - O(n) на индекс и O(1) на запрос
+Память: O(суммарной длины строк) в режимах `--batch` и `--substrings`, O(максимальной длины строки)
+иначе
+
 */
 
-int main() {
-  int16_t t;
+constexpr size_t BlockSize = 8 << 20;
 
-  std::cin >> t;
+// Копит вывод и отдает его в файл кусками по Capacity байт
+class BufferedWriter {
+  static constexpr size_t Capacity = 1 << 16;
 
-  while (t-- > 0) {
-    std::string line;
+  std::FILE* file_;
+  std::string buffer_;
 
-    std::cin >> line;
+public:
+  explicit BufferedWriter(std::FILE* file) : file_(file) {
+    buffer_.reserve(Capacity);
+  }
+
+  BufferedWriter(const BufferedWriter&) = delete;
+  BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+  ~BufferedWriter() {
+    Flush();
+  }
+
+  void Write(std::string_view data) {
+    if (buffer_.size() + data.size() > Capacity) {
+      Flush();
+    }
+    if (data.size() >= Capacity) {
+      std::fwrite(data.data(), 1, data.size(), file_);
+      return;
+    }
+    buffer_ += data;
+  }
+
+  void Flush() {
+    if (!buffer_.empty()) {
+      std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+      buffer_.clear();
+    }
+  }
+};
+
+// Отвечает на записи из [begin, end): запись - строка до '\n', завершающий '\r' отбрасывается.
+// Пустые строки записями не считаются
+template <typename Check = decltype(&IsSquare)>
+void AnswerRecords(const char* begin, const char* end, std::string& out, Check check = IsSquare) {
+  out.reserve(out.size() + (end - begin) / 2);
+
+  const char* ptr = begin;
+  while (ptr < end) {
+    const void* newline = std::memchr(ptr, '\n', end - ptr);
+    const char* line_end = newline != nullptr ? static_cast<const char*>(newline) : end;
+
+    std::string_view line(ptr, line_end - ptr);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (!line.empty()) {
+      out += check(line) ? "YES\n" : "NO\n";
+    }
+
+    ptr = line_end + 1;
+  }
+}
+
+// Блок начинается не раньше begin + BlockSize и заканчивается сразу после перевода строки
+const char* NextBlockEnd(const char* begin, const char* end) {
+  if (static_cast<size_t>(end - begin) <= BlockSize) {
+    return end;
+  }
+  const void* newline = std::memchr(begin + BlockSize, '\n', end - begin - BlockSize);
+  return newline != nullptr ? static_cast<const char*>(newline) + 1 : end;
+}
 
-    const size_t size = line.size();
+// Делит [begin, end) на блоки и отвечает на них раундами по threads блоков: answer(begin, end, out)
+// пишет ответы блока в out, буферы раунда отдаются писателю в исходном порядке
+template <typename Answer>
+void AnswerInBlocks(
+    const char* begin,
+    const char* end,
+    uint32_t threads,
+    BufferedWriter& writer,
+    Answer answer
+) {
+  threads = std::max<uint32_t>(threads, 1);
 
-    if ((size & 0x1) > 0) {
-      std::cout << "NO" << '\n';
-      continue;
+  std::vector<std::string> outputs(threads);
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+
+  const char* ptr = begin;
+  while (ptr < end) {
+    std::vector<const char*> bounds{ptr};
+    while (bounds.size() <= threads && bounds.back() < end) {
+      bounds.push_back(NextBlockEnd(bounds.back(), end));
+    }
+    const size_t blocks = bounds.size() - 1;
+
+    for (size_t i = 1; i < blocks; i++) {
+      outputs[i].clear();
+      workers.emplace_back(answer, bounds[i], bounds[i + 1], std::ref(outputs[i]));
+    }
+    outputs[0].clear();
+    answer(bounds[0], bounds[1], outputs[0]);
+    for (auto& worker : workers) {
+      worker.join();
     }
+    workers.clear();
 
-    bool is_squared = true;
+    for (size_t i = 0; i < blocks; i++) {
+      writer.Write(outputs[i]);
+    }
+    ptr = bounds.back();
+  }
+}
 
-    const size_t half = size >> 1;
-    for (size_t i = 0; i < half; i++) {
-      if (line[i] != line[half + i]) {
-        is_squared = false;
-        break;
+template <typename Check = decltype(&IsSquare)>
+void AnswerAllRecords(
+    const char* begin,
+    const char* end,
+    uint32_t threads,
+    BufferedWriter& writer,
+    Check check = IsSquare
+) {
+  auto answer = [check](const char* block_begin, const char* block_end, std::string& out) {
+    AnswerRecords(block_begin, block_end, out, check);
+  };
+  AnswerInBlocks(begin, end, threads, writer, answer);
+}
+
+// Запросы "l r" (нумерация с 1, границы включительно) - является ли квадратом s[l..r]. Запросы
+// разбираются пачками по QueryBatch: после разбора пачки строки хешей уже запрошены из памяти
+// (Prefetch), и промахи кеша разных запросов перекрываются, а не идут друг за другом
+void AnswerSubstringBlock(
+    const SquareIndex& index,
+    const char* begin,
+    const char* end,
+    std::string& out
+) {
+  constexpr size_t QueryBatch = 64;
+
+  out.reserve(out.size() + (end - begin) / 4);
+
+  std::array<std::pair<uint64_t, uint64_t>, QueryBatch> batch;
+  const char* ptr = begin;
+  while (ptr < end) {
+    size_t count = 0;
+    while (count < QueryBatch && ptr < end) {
+      const void* newline = std::memchr(ptr, '\n', end - ptr);
+      const char* line_end = newline != nullptr ? static_cast<const char*>(newline) : end;
+
+      // Пустые строки запросами не считаются (так же их пропускает SkipLines)
+      if (SkipToNumber(ptr, line_end)) {
+        const uint64_t l = ReadNumber(ptr, line_end);
+        const uint64_t r = ReadNumber(ptr, line_end);
+        batch[count] = {l > 0 ? l - 1 : index.Size() + 1, r};
+        index.Prefetch(batch[count].first, batch[count].second);
+        count++;
       }
+
+      ptr = line_end + 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+      out += index.IsSquare(batch[i].first, batch[i].second) ? "YES\n" : "NO\n";
+    }
+  }
+}
+
+void AnswerSubstringQueries(
+    const SquareIndex& index,
+    const char* begin,
+    const char* end,
+    uint32_t threads,
+    BufferedWriter& writer
+) {
+  auto answer = [&index](const char* block_begin, const char* block_end, std::string& out) {
+    AnswerSubstringBlock(index, block_begin, block_end, out);
+  };
+  AnswerInBlocks(begin, end, threads, writer, answer);
+}
+
+// Записи четной длины от min_length до max_length, примерно половина из них - квадраты. У остальных
+// половины отличаются только последним символом, чтобы сравнение шло до конца
+std::string RandomRecords(size_t count, size_t min_length, size_t max_length, std::mt19937& rng) {
+  std::string records;
+  records.reserve(count * (min_length + max_length) / 2 + count);
+  for (size_t i = 0; i < count; i++) {
+    const size_t half = (min_length + rng() % (max_length - min_length + 1)) / 2;
+    const size_t start = records.size();
+    for (size_t j = 0; j < half; j++) {
+      records += static_cast<char>('a' + rng() % 26);
+    }
+    records.append(records, start, half);
+    if (half > 0 && rng() % 2 == 0) {
+      records.back() = records.back() == 'z' ? 'a' : 'z';
     }
+    records += '\n';
+  }
+  return records;
+}
+
+void RunBatchBenchmark(uint32_t max_threads) {
+  struct Workload {
+    const char* name;
+    size_t count;
+    size_t min_length;
+    size_t max_length;
+  };
+  const Workload workloads[] = {
+      {"short", 20000000, 2, 100},
+      {"long", 512, 1 << 20, 2 << 20},
+  };
+
+  std::FILE* null = std::fopen("/dev/null", "w");
+  if (null == nullptr) {
+    std::perror("/dev/null");
+    return;
+  }
+
+  std::mt19937 rng(42);
+  for (const Workload& workload : workloads) {
+    const std::string records =
+        RandomRecords(workload.count, workload.min_length, workload.max_length, rng);
+    const char* begin = records.data();
+    const char* end = begin + records.size();
+
+    auto run = [&](const char* engine, uint32_t threads, auto check) {
+      double best_ms = 1e18;
+      for (int32_t i = 0; i < 3; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        BufferedWriter writer(null);
+        AnswerAllRecords(begin, end, threads, writer, check);
+        writer.Flush();
+        const auto finish = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+        best_ms = std::min(best_ms, ms);
+      }
+      std::printf(
+          "%-5s %-6s threads=%-2u time=%8.2fms records/s=%.3e throughput=%.2fGB/s\n",
+          workload.name,
+          engine,
+          threads,
+          best_ms,
+          workload.count / best_ms * 1e3,
+          records.size() / best_ms / 1e6
+      );
+    };
+
+    run("chars", 1, IsSquareByChars);
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+      run("memcmp", threads, IsSquare);
+    }
+  }
+  std::fclose(null);
+}
+
+void RunIndexBenchmark(uint32_t threads) {
+  constexpr size_t N = 10000000;
+  constexpr size_t Q = 10000000;
+  constexpr size_t Checked = 100000;
+
+  auto elapsed_ms = [](auto start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  // Лента из повторенных дважды случайных блоков длины до 1000: половина запросов попадает ровно
+  // в такой квадрат, вторая половина - случайные подстроки четной длины до 2000
+  std::mt19937 rng(42);
+  std::string s;
+  s.reserve(N + 2000);
+  std::vector<std::pair<size_t, size_t>> squares;
+  while (s.size() < N) {
+    const size_t half = 1 + rng() % 1000;
+    const size_t start = s.size();
+    for (size_t j = 0; j < half; j++) {
+      s += static_cast<char>('a' + rng() % 2);
+    }
+    s.append(s, start, half);
+    squares.emplace_back(start, s.size());
+  }
+  s.resize(N);
+  squares.pop_back();
+
+  std::vector<std::pair<size_t, size_t>> queries(Q);
+  for (auto& [l, r] : queries) {
+    if (rng() % 2 == 0) {
+      std::tie(l, r) = squares[rng() % squares.size()];
+    } else {
+      l = rng() % (N - 2000);
+      r = l + 2 * (1 + rng() % 1000);
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const SquareIndex index(s, 42);
+  const double build_ms = elapsed_ms(start);
+  std::printf("n=%zu build=%.2fms memory=%zuMB\n", N, build_ms, index.MemoryBytes() >> 20);
+
+  size_t yes = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto& [l, r] : queries) {
+    yes += index.IsSquare(l, r);
+  }
+  const double index_ms = elapsed_ms(start);
+
+  size_t mismatches = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < Checked; i++) {
+    const auto [l, r] = queries[i];
+    mismatches += IsSquare(std::string_view(s).substr(l, r - l)) != index.IsSquare(l, r);
+  }
+  const double memcmp_ms = elapsed_ms(start);
+
+  std::printf(
+      "Q=%zu yes=%zu index: %.2fms (%.1fns/query), memcmp: %.1fns/query, mismatches=%zu/%zu\n",
+      Q,
+      yes,
+      index_ms,
+      index_ms * 1e6 / Q,
+      memcmp_ms * 1e6 / Checked,
+      mismatches,
+      Checked
+  );
+
+  // Тот же набор запросов через потоковый режим: разбор текста и вывод ответов
+  std::string input;
+  for (const auto& [l, r] : queries) {
+    input += std::to_string(l + 1) + ' ' + std::to_string(r) + '\n';
+  }
+  std::FILE* null = std::fopen("/dev/null", "w");
+  if (null == nullptr) {
+    std::perror("/dev/null");
+    return;
+  }
+  for (uint32_t t = 1; t <= threads; t *= 2) {
+    start = std::chrono::steady_clock::now();
+    {
+      BufferedWriter writer(null);
+      AnswerSubstringQueries(index, input.data(), input.data() + input.size(), t, writer);
+    }
+    const double ms = elapsed_ms(start);
+    std::printf("query stream threads=%u: %.2fms (%.1fns/query)\n", t, ms, ms * 1e6 / Q);
+  }
+  std::fclose(null);
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t threads = std::thread::hardware_concurrency();
+  bool batch = false;
+  bool bench = false;
+  bool substrings = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoul(argv[++i]);
+    } else if (arg == "--batch") {
+      batch = true;
+    } else if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--substrings") {
+      substrings = true;
+    }
+  }
+  threads = std::max<uint32_t>(threads, 1);
+
+  if (bench && substrings) {
+    RunIndexBenchmark(threads);
+    return 0;
+  }
+  if (bench) {
+    RunBatchBenchmark(threads);
+    return 0;
+  }
+
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
+  BufferedWriter writer(stdout);
+
+  if (batch || substrings) {
+    const std::string input(std::istreambuf_iterator<char>(std::cin), {});
+    const char* ptr = input.data();
+    const char* end = ptr + input.size();
+
+    if (batch) {
+      AnswerAllRecords(ptr, end, threads, writer);
+      return 0;
+    }
+
+    // Первая строка - s, вторая - Q, затем Q строк запросов; все, что после них, не читается
+    const char* newline = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+    std::string_view s(ptr, (newline != nullptr ? newline : end) - ptr);
+    if (!s.empty() && s.back() == '\r') {
+      s.remove_suffix(1);
+    }
+    const SquareIndex index(s);
+
+    ptr = newline != nullptr ? newline : end;
+    const uint64_t q = ReadNumber(ptr, end);
+    const void* queries = std::memchr(ptr, '\n', end - ptr);
+    ptr = queries != nullptr ? static_cast<const char*>(queries) + 1 : end;
+    AnswerSubstringQueries(index, ptr, SkipLines(ptr, end, q), threads, writer);
+    return 0;
+  }
+
+  int16_t t;
+
+  std::cin >> t;
+
+  while (t-- > 0) {
+    std::string line;
+
+    std::cin >> line;
 
-    if (is_squared) {
-      std::cout << "YES" << '\n';
+    if (IsSquare(line)) {
+      writer.Write("YES\n");
     } else {
-      std::cout << "NO" << '\n';
+      writer.Write("NO\n");
     }
   }
 
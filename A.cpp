@@ -1,7 +1,16 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <random>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "advalgo/persistent_zero_tree.hpp"
+#include "advalgo/segmented_array.hpp"
+
 /*
 
 # A. K-ый ноль
@@ -43,138 +52,398 @@ BLOCK_SIZE). Наименьшее значение выведенная функ
 квадратному корню из N. Таким образом, BLOCK_SIZE лучше всего брать ближайшей степенью двойки к
 квадратному корню из N. При условиях, данных в задаче - 256 или 512.
 
+## Присваивание на отрезке
+Запрос a l r v (расширение формата, ответа не печатает) присваивает v всем элементам [l, r].
+Для блоков, целиком попавших в отрезок, маска нулей заполняется словами подряд, а счетчик нулей
+становится равен размеру блока или нулю за O(1). Если массив хранит значения, такие блоки
+помечаются однородными, и значения записываются только перед следующим изменением отдельного
+элемента блока. Честно присваиваются лишь элементы двух граничных блоков, поэтому запрос стоит
+O(BLOCK_SIZE + BLOCKS_COUNT), как и поиск, а не O(r - l).
+
+`A --bench` сравнивает AssignRange с циклом Update на случайных отрезках вперемешку с поиском.
+
+## Хранение
+Поиску нужно только знать, какие элементы нулевые, поэтому массив хранится битовой маской нулей
+(бит на элемент вместо 32): блок из 128 элементов занимает два слова, и частичные блоки
+просматриваются через popcount вместо цикла по элементам. Значения хранятся только по запросу -
+решению они не нужны - и занимают от 1 до 4 байт на элемент по наибольшему значению (для значений
+до 100000 - 3 байта).
+
+`A --storage --bench` печатает память и время поиска для N = 2 * 10^5 и N = 10^8.
+
+## Маленькие k
+Чаще всего ищется первый или второй ноль. Для k = 1 и k = 2 поиск идет через ядра FindFirstZero и
+FindKthZero<2>, в которых k - параметр шаблона: блоки без нулей пропускаются по битовой маске
+непустых блоков (tzcnt по слову маски вместо цикла по счетчикам), а в слове с нулями снимаются одна
+или две младшие единицы без popcount. Остальные k ищет общий Search.
+
+`A --small-k --bench` сравнивает ядра с Search при разной доле нулей.
+
+## Версии
+С флагом `--history` решение отвечает и на запросы h t l r k - k-тый ноль на [l, r] в массиве после
+первых t обновлений (t = 0 - исходный массив; если обновлений пока меньше t, то ответ -1). Для
+этого используется персистентное дерево отрезков по количеству нулей (PersistentZeroTree):
+обновление копирует путь от корня до листа, то есть создает O(log N) новых вершин, а остальные
+вершины общие с предыдущей версией. Поиск считает нули левее l спуском от корня версии t и вторым
+спуском находит ноль с нужным номером - O(log N).
+
+`A --history --bench` печатает рост памяти за 2 * 10^5 обновлений и время поиска в прошлых версиях.
+
 ## Асимптотика решения
 Время: O(M * sqrt(N))
 Память: O(N)
 
 */
 
-constexpr uint32_t BlockSizeShift = 7;  // размер блока равен 2^BlockSizeShift
-
-class SegmentedArray {
-  uint32_t block_size_;
-  std::vector<uint32_t> array_;
-  std::vector<uint16_t> zeros_;
+// Случайные присваивания на отрезках вперемешку с поиском k-го нуля. Присваивание делается через
+// AssignRange или циклом по Update, суммы ответов поиска должны совпасть
+void RunAssignBenchmark() {
+  constexpr uint32_t N = 200000;
+  constexpr uint32_t Q = 5000;
+
+  struct Query {
+    uint32_t left;
+    uint32_t right;
+    uint32_t value;
+    uint32_t k;
+  };
+
+  std::mt19937 rng(42);
+  std::vector<uint32_t> source(N);
+  for (auto& value : source) {
+    value = rng() % 4;
+  }
+  std::vector<Query> queries(Q);
+  for (auto& query : queries) {
+    query.left = 1 + rng() % N;
+    query.right = 1 + rng() % N;
+    if (query.left > query.right) {
+      std::swap(query.left, query.right);
+    }
+    query.value = rng() % 2 == 0 ? 0 : 1 + rng() % 100000;
+    query.k = 1 + rng() % N;
+  }
 
-public:
-  explicit SegmentedArray(const std::vector<uint32_t>& source)
-      : block_size_(static_cast<uint32_t>(1) << BlockSizeShift), array_(source) {
-    const uint32_t size = array_.size();
-    uint32_t blocks_count = size >> BlockSizeShift;
-    if ((size & (block_size_ - 1)) > 0) {
-      blocks_count++;
+  auto run = [&](const char* engine, auto assign) {
+    double best_ms = 1e18;
+    int64_t checksum = 0;
+    for (int32_t i = 0; i < 3; i++) {
+      SegmentedArray array(source);
+      checksum = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (const Query& query : queries) {
+        assign(array, query);
+        checksum += array.Search(1, N, query.k % (query.right - query.left + 1) + 1);
+      }
+      const auto finish = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+      best_ms = std::min(best_ms, ms);
     }
+    std::printf(
+        "%-8s N=%u Q=%u time=%8.2fms ns/query=%.1f checksum=%lld\n",
+        engine,
+        N,
+        Q,
+        best_ms,
+        best_ms * 1e6 / Q,
+        static_cast<long long>(checksum)
+    );
+  };
+
+  run("assign", [](SegmentedArray& array, const Query& query) {
+    array.AssignRange(query.left, query.right, query.value);
+  });
+  run("updates", [](SegmentedArray& array, const Query& query) {
+    for (uint32_t i = query.left; i <= query.right; i++) {
+      array.Update(i, query.value);
+    }
+  });
+}
 
-    zeros_ = std::vector<uint16_t>(blocks_count, 0);
+// Память и время поиска для маски нулей без значений и со значениями. Для сравнения печатается
+// размер прежнего хранения - uint32_t на элемент плюс счетчики блоков
+void RunStorageBenchmark() {
+  struct Workload {
+    uint32_t n;
+    uint32_t queries;
+  };
+  const Workload workloads[] = {
+      {200000, 1000000},
+      {100000000, 2000},
+  };
+
+  std::mt19937 rng(42);
+  for (const Workload& workload : workloads) {
+    const uint32_t n = workload.n;
+    std::vector<uint32_t> source(n);
+    for (auto& value : source) {
+      value = rng() % 4 == 0 ? 0 : 1 + rng() % 100000;
+    }
 
-    for (uint32_t i = 0; i < size; i++) {
-      if (array_[i] == 0) {
-        zeros_[BlockOfElement(i)]++;
+    struct Query {
+      uint32_t left;
+      uint32_t right;
+      uint32_t k;
+    };
+    std::vector<Query> queries(workload.queries);
+    for (auto& query : queries) {
+      query.left = 1 + rng() % n;
+      query.right = 1 + rng() % n;
+      if (query.left > query.right) {
+        std::swap(query.left, query.right);
       }
+      query.k = 1 + rng() % ((query.right - query.left) / 4 + 1);
     }
-  }
 
-  void Update(const uint32_t index, const uint32_t new_value) {
-    const uint32_t idx = index - 1;
+    const uint64_t blocks = (uint64_t{n} + (1 << BlockSizeShift) - 1) >> BlockSizeShift;
+    std::printf("N=%u uint32 layout: memory=%.2fMB\n", n, (4.0 * n + 2.0 * blocks) / 1e6);
 
-    const uint32_t old_value = array_[idx];
+    for (const bool keep_values : {false, true}) {
+      const SegmentedArray array(source, keep_values);
 
-    // Если новое значение равно старому, то обновлять ничего не нужно
-    if (old_value == new_value) {
-      return;
+      int64_t checksum = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (const Query& query : queries) {
+        checksum += array.Search(query.left, query.right, query.k);
+      }
+      const auto finish = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+
+      std::printf(
+          "N=%u %-12s memory=%.2fMB bits/element=%.2f ns/query=%.1f checksum=%lld\n",
+          n,
+          keep_values ? "bits+values" : "bits",
+          array.MemoryBytes() / 1e6,
+          array.MemoryBytes() * 8.0 / n,
+          ms * 1e6 / queries.size(),
+          static_cast<long long>(checksum)
+      );
     }
+  }
+}
 
-    array_[idx] = new_value;
+// k известен только при выполнении, поэтому ядро для маленького k выбирается одним switch на запрос
+int32_t SearchKthZero(
+    const SegmentedArray& array,
+    const uint32_t left,
+    const uint32_t right,
+    const uint32_t k_value
+) {
+  switch (k_value) {
+    case 1:
+      return array.FindFirstZero(left, right);
+    case 2:
+      return array.FindKthZero<2>(left, right);
+    default:
+      return array.Search(left, right, k_value);
+  }
+}
 
-    // Уменьшаем счетчик 0, если затерли значение 0
-    if (old_value == 0) {
-      zeros_[BlockOfElement(idx)]--;
+// Время поиска первого и второго нуля общим Search и ядрами FindFirstZero / FindKthZero<2> при
+// разной доле нулей в массиве
+void RunSmallKBenchmark() {
+  constexpr uint32_t N = 200000;
+  constexpr uint32_t Q = 1000000;
+
+  struct Density {
+    const char* name;
+    uint32_t one_in;  // доля нулей - 1 / one_in
+  };
+  constexpr Density Densities[] = {{"dense", 4}, {"sparse", 1000}, {"rare", 100000}};
+
+  std::mt19937 rng(42);
+  std::vector<std::pair<uint32_t, uint32_t>> queries(Q);
+  for (auto& [left, right] : queries) {
+    left = 1 + rng() % N;
+    right = 1 + rng() % N;
+    if (left > right) {
+      std::swap(left, right);
     }
+  }
 
-    // Увеличиваем счетчик 0, если записываем новый 0
-    if (new_value == 0) {
-      zeros_[BlockOfElement(idx)]++;
+  for (const Density& density : Densities) {
+    std::vector<uint32_t> source(N);
+    for (auto& value : source) {
+      value = rng() % density.one_in == 0 ? 0 : 1 + rng() % 100000;
     }
+    const SegmentedArray array(source);
+
+    auto run = [&](const char* engine, auto search) {
+      int64_t checksum = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto& [left, right] : queries) {
+        checksum += search(left, right);
+      }
+      const auto finish = std::chrono::steady_clock::now();
+      std::printf("%-6s %-14s ns/query=%.1f checksum=%lld\n", density.name, engine,
+                  std::chrono::duration<double, std::nano>(finish - start).count() / Q,
+                  static_cast<long long>(checksum));
+    };
+
+    run("Search(k=1)", [&](uint32_t l, uint32_t r) { return array.Search(l, r, 1); });
+    run("FindFirstZero", [&](uint32_t l, uint32_t r) { return array.FindFirstZero(l, r); });
+    run("Search(k=2)", [&](uint32_t l, uint32_t r) { return array.Search(l, r, 2); });
+    run("FindKthZero<2>", [&](uint32_t l, uint32_t r) { return array.FindKthZero<2>(l, r); });
   }
+}
 
-  int32_t Search(const uint32_t left_bound, const uint32_t right_bound, const uint32_t k_value) {
-    if (left_bound > right_bound) {
-      return -1;
-    }
+// Режим --history: те же запросы, что и в основном режиме, плюс h t l r k - поиск в версии t
+// (после первых t обновлений). Присваивание на отрезке раскладывается на обновления элементов,
+// каждое из которых создает версию
+std::string AnswerWithHistory(const std::vector<uint32_t>& array, uint32_t m_value) {
+  PersistentZeroTree tree(array);
+  std::string output;
 
-    const uint32_t left = left_bound - 1;
-    const uint32_t right = right_bound - 1;
+  while (m_value-- > 0) {
+    char command = 0;
+    std::cin >> command;
 
-    const uint32_t left_block = BlockOfElement(left);
-    const uint32_t right_block = BlockOfElement(right);
+    if (command == 'u') {
+      uint32_t idx = 0;
+      uint32_t new_value = 0;
+      std::cin >> idx >> new_value;
 
-    // Если границы попали на один блок, то считаем честно через цикл
-    if (left_block == right_block) {
-      uint32_t zeros_count = 0;
-      for (uint32_t i = left; i <= right; i++) {
-        if (array_[i] == 0 && ++zeros_count == k_value) {
-          return static_cast<int32_t>(i + 1);
-        }
-      }
-      return -1;
-    }
+      tree.Update(idx, new_value);
+    } else if (command == 'a') {
+      uint32_t left = 0;
+      uint32_t right = 0;
+      uint32_t new_value = 0;
+      std::cin >> left >> right >> new_value;
 
-    uint32_t zeros_count = 0;
-    uint32_t idx = left;
-    uint32_t i_block = left_block;
-
-    // Считаем 0 в правой части блока, в который попала левая граница
-    if (FirstIndexOfBlock(left_block) != left) {
-      while (i_block == left_block) {
-        if (array_[idx] == 0 && ++zeros_count == k_value) {
-          return static_cast<int32_t>(idx + 1);
-        }
-        idx++;
-        i_block = BlockOfElement(idx);
+      for (uint32_t idx = left; idx <= right; idx++) {
+        tree.Update(idx, new_value);
       }
+    } else {
+      uint32_t version = tree.Versions() - 1;
+      if (command == 'h') {
+        std::cin >> version;
+      }
+
+      uint32_t left = 0;
+      uint32_t right = 0;
+      uint32_t k_value = 0;
+      std::cin >> left >> right >> k_value;
+
+      output += std::to_string(tree.Search(version, left, right, k_value)) + '\n';
     }
+  }
+  return output;
+}
 
-    // Считаем 0 в блоках между блоками, в которые попали левая и правая границы
-    while (i_block < right_block) {
-      // Если в промежуточном блоке нашли нужный k-тый 0
-      if (zeros_count + zeros_[i_block] >= k_value) {
-        // Честно итерируемся по блоку
-        idx = FirstIndexOfBlock(i_block);
-        while (zeros_count < k_value) {
-          if (array_[idx] == 0) {
-            zeros_count++;
-          }
-          idx++;
-        }
-        return static_cast<int32_t>(idx);
-      }
+// Рост памяти персистентного дерева по мере обновлений и время поиска в случайной прошлой версии,
+// в последней версии и в SegmentedArray (только последняя версия)
+void RunHistoryBenchmark() {
+  constexpr uint32_t N = 200000;
+  constexpr uint32_t U = 200000;
+  constexpr uint32_t Q = 1000000;
+
+  std::mt19937 rng(42);
+  std::vector<uint32_t> source(N);
+  for (auto& value : source) {
+    value = rng() % 4 == 0 ? 0 : 1 + rng() % 100000;
+  }
 
-      zeros_count += zeros_[i_block];
-      i_block++;
+  PersistentZeroTree tree(source);
+  SegmentedArray latest(source);
+  std::printf("versions=%-7u nodes=%-9zu memory=%.2fMB\n", tree.Versions(), tree.NodeCount(),
+              tree.MemoryBytes() / 1e6);
+
+  const size_t initial_nodes = tree.NodeCount();
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 1; i <= U; i++) {
+    const uint32_t idx = 1 + rng() % N;
+    const uint32_t value = rng() % 2 == 0 ? 0 : 1 + rng() % 100000;
+    tree.Update(idx, value);
+    latest.Update(idx, value);
+    if (i % (U / 4) == 0) {
+      std::printf(
+          "versions=%-7u nodes=%-9zu memory=%.2fMB bytes/version=%.1f\n",
+          tree.Versions(),
+          tree.NodeCount(),
+          tree.MemoryBytes() / 1e6,
+          (tree.NodeCount() - initial_nodes) * 12.0 / i
+      );
+    }
+  }
+  const auto finish = std::chrono::steady_clock::now();
+  std::printf("update: ns/op=%.1f\n",
+              std::chrono::duration<double, std::nano>(finish - start).count() / U);
+
+  struct Query {
+    uint32_t version;
+    uint32_t left;
+    uint32_t right;
+    uint32_t k;
+  };
+  std::vector<Query> queries(Q);
+  for (auto& query : queries) {
+    query.version = rng() % tree.Versions();
+    query.left = 1 + rng() % N;
+    query.right = 1 + rng() % N;
+    if (query.left > query.right) {
+      std::swap(query.left, query.right);
     }
+    query.k = 1 + rng() % ((query.right - query.left) / 4 + 1);
+  }
 
-    // Честно итерируемся по блоку, в который попала правая граница
-    for (idx = FirstIndexOfBlock(right_block); idx <= right; idx++) {
-      if (array_[idx] == 0 && ++zeros_count == k_value) {
-        return static_cast<int32_t>(idx + 1);
-      }
+  auto run = [&](const char* engine, auto search) {
+    int64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const Query& query : queries) {
+      checksum += search(query);
     }
+    const auto finish = std::chrono::steady_clock::now();
+    std::printf("%-16s ns/query=%.1f checksum=%lld\n", engine,
+                std::chrono::duration<double, std::nano>(finish - start).count() / Q,
+                static_cast<long long>(checksum));
+  };
+
+  run("history", [&](const Query& query) {
+    return tree.Search(query.version, query.left, query.right, query.k);
+  });
+  run("history/latest", [&](const Query& query) {
+    return tree.Search(tree.Versions() - 1, query.left, query.right, query.k);
+  });
+  run("segmented", [&](const Query& query) {
+    return latest.Search(query.left, query.right, query.k);
+  });
+}
 
-    // Нужного k-того 0 на промежутке не нашли
-    return -1;
+int main(int argc, char* argv[]) {
+  bool bench = false;
+  bool storage = false;
+  bool history = false;
+  bool small_k = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--storage") {
+      storage = true;
+    } else if (arg == "--history") {
+      history = true;
+    } else if (arg == "--small-k") {
+      small_k = true;
+    }
   }
 
-private:
-  static uint32_t BlockOfElement(const uint32_t index) {
-    return index >> BlockSizeShift;
+  if (bench && small_k) {
+    RunSmallKBenchmark();
+    return 0;
   }
-
-  static uint32_t FirstIndexOfBlock(const uint32_t block) {
-    return block << BlockSizeShift;
+  if (bench && history) {
+    RunHistoryBenchmark();
+    return 0;
+  }
+  if (bench && storage) {
+    RunStorageBenchmark();
+    return 0;
+  }
+  if (bench) {
+    RunAssignBenchmark();
+    return 0;
   }
-};
 
-int main() {
   // Немного магии, которую я честно не понимаю
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
@@ -190,10 +459,15 @@ int main() {
     array[i] = value;
   }
 
-  SegmentedArray tree(array);
-
   uint32_t m_value = 0;
   std::cin >> m_value;
+
+  if (history) {
+    std::cout << AnswerWithHistory(array, m_value);
+    return 0;
+  }
+
+  SegmentedArray tree(array);
   std::string output;
 
   while (m_value-- > 0) {
@@ -209,6 +483,14 @@ int main() {
       std::cin >> new_value;
 
       tree.Update(idx, new_value);
+    } else if (command == 'a') {
+      // Присваиваем значение всем элементам отрезка
+      uint32_t left = 0;
+      uint32_t right = 0;
+      uint32_t new_value = 0;
+      std::cin >> left >> right >> new_value;
+
+      tree.AssignRange(left, right, new_value);
     } else {
       // Обрабатываем команду поиска k-того 0
       uint32_t left = 0;
@@ -220,7 +502,7 @@ int main() {
       uint32_t k_value = 0;
       std::cin >> k_value;
 
-      const int32_t idx = tree.Search(left, right, k_value);
+      const int32_t idx = SearchKthZero(tree, left, right, k_value);
       output += std::to_string(idx) + '\n';
     }
   }
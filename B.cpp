@@ -1,7 +1,17 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "advalgo/bit_counter.hpp"
+#include "advalgo/concurrent_bit_counter.hpp"
+
 /*
 
 # B. Количество единиц в двоичной записи
@@ -47,6 +57,17 @@
 <...>
 ```
 
+## Общий счетчик
+Если x - общая статистика, которую меняют несколько потоков, то массив байт с общим счетчиком
+единиц одновременно менять нельзя. Для этого есть ConcurrentBitCounter: x хранится атомарными
+словами по 64 разряда, прибавление - fetch_add к одному слову, перенос - fetch_add к следующему,
+только если слово переполнилось (вычитание аналогично с заемом). Количество единиц считается
+popcount по словам и точно, когда потоки, меняющие x, остановлены.
+
+`B --bench` сравнивает пропускную способность ConcurrentBitCounter и BitCounter под общим
+мьютексом для числа потоков от 1 до количества ядер (`--threads K`) на двух нагрузках: S до 10^5
+(потоки почти не задевают одни и те же слова) и S < 256 (все потоки меняют четыре слова).
+
 ## Асимптотика решения
 Время: O(n * S)
 Память: O(S)
@@ -55,15 +76,138 @@
 
 */
 
-int main() {
+// BitCounter под мьютексом - эталон для сравнения с ConcurrentBitCounter
+class LockedBitCounter {
+  std::mutex mutex_;
+  BitCounter counter_;
+
+public:
+  void Add(const uint32_t S) {
+    const std::lock_guard lock(mutex_);
+    counter_.Add(S);
+  }
+
+  void Subtract(const uint32_t S) {
+    const std::lock_guard lock(mutex_);
+    counter_.Subtract(S);
+  }
+
+  uint32_t Ones() {
+    const std::lock_guard lock(mutex_);
+    return counter_.Ones();
+  }
+};
+
+// Операция потока: S со знаком, отрицательное значение - вычитание 2^(-S - 1)
+using CounterOps = std::vector<int32_t>;
+
+// Операции одного потока. Поток вычитает только то, что сам прибавил, поэтому после завершения
+// всех потоков x неотрицателен
+CounterOps RandomCounterOps(const uint32_t count, const uint32_t max_s, std::mt19937& rng) {
+  CounterOps ops;
+  ops.reserve(count);
+  std::vector<int32_t> added;
+  for (uint32_t i = 0; i < count; i++) {
+    if (added.empty() || rng() % 3 != 0) {
+      added.push_back(static_cast<int32_t>(rng() % max_s));
+      ops.push_back(added.back());
+    } else {
+      std::swap(added[rng() % added.size()], added.back());
+      ops.push_back(-added.back() - 1);
+      added.pop_back();
+    }
+  }
+  return ops;
+}
+
+// Выполняет операции всех потоков над counter и возвращает время в миллисекундах
+template <typename Counter>
+double RunCounterThreads(Counter& counter, const std::vector<CounterOps>& ops) {
+  auto work = [&counter](const CounterOps& thread_ops) {
+    for (const int32_t op : thread_ops) {
+      if (op >= 0) {
+        counter.Add(op);
+      } else {
+        counter.Subtract(-op - 1);
+      }
+    }
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  workers.reserve(ops.size() - 1);
+  for (size_t i = 1; i < ops.size(); i++) {
+    workers.emplace_back(work, std::cref(ops[i]));
+  }
+  work(ops[0]);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const auto finish = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+// Пропускная способность ConcurrentBitCounter и BitCounter под мьютексом при разном числе потоков.
+// Общее число операций фиксировано и делится между потоками поровну
+void RunConcurrentBenchmark(const uint32_t max_threads) {
+  constexpr uint32_t Total = 4000000;
+
+  struct Workload {
+    const char* name;
+    uint32_t max_s;
+  };
+  constexpr Workload Workloads[] = {{"spread", 100001}, {"hot", 256}};
+
+  for (const Workload& workload : Workloads) {
+    for (uint32_t threads = 1; threads <= max_threads; threads++) {
+      std::mt19937 rng(42);
+      std::vector<CounterOps> ops;
+      for (uint32_t i = 0; i < threads; i++) {
+        ops.push_back(RandomCounterOps(Total / threads, workload.max_s, rng));
+      }
+
+      LockedBitCounter locked;
+      ConcurrentBitCounter concurrent;
+      const double locked_ms = RunCounterThreads(locked, ops);
+      const double concurrent_ms = RunCounterThreads(concurrent, ops);
+      if (locked.Ones() != concurrent.Ones()) {
+        std::printf("%s threads=%u: ones mismatch %u != %u\n", workload.name, threads,
+                    concurrent.Ones(), locked.Ones());
+        return;
+      }
+
+      const double ops_count = static_cast<double>(Total / threads) * threads;
+      std::printf("%-6s threads=%u mutex=%.1fMops/s atomic=%.1fMops/s ones=%u\n", workload.name,
+                  threads, ops_count / locked_ms / 1e3, ops_count / concurrent_ms / 1e3,
+                  concurrent.Ones());
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t threads = std::thread::hardware_concurrency();
+  bool bench = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoul(argv[++i]);
+    } else if (arg == "--bench") {
+      bench = true;
+    }
+  }
+
+  if (bench) {
+    RunConcurrentBenchmark(std::max<uint32_t>(threads, 1));
+    return 0;
+  }
+
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
 
   uint32_t n = 0;
   std::cin >> n;
 
-  std::vector<int8_t> bits(200000, 0);
-  uint32_t ones = 0;
+  BitCounter counter;
 
   std::string output;
 
@@ -75,32 +219,12 @@ int main() {
     std::cin >> S;
 
     if (op == '+') {
-      bits[S]++;
-
-      while (bits[S] == 2) {
-        bits[S] = 0;
-        ones--;
-
-        S++;
-        bits[S]++;
-      }
-
-      ones++;
+      counter.Add(S);
     } else {
-      bits[S]--;
-
-      while (bits[S] == -1) {
-        bits[S] = 1;
-        ones++;
-
-        S++;
-        bits[S]--;
-      }
-
-      ones--;
+      counter.Subtract(S);
     }
 
-    output += std::to_string(ones) + '\n';
+    output += std::to_string(counter.Ones()) + '\n';
   }
 
   std::cout << output;
@@ -1,13 +1,24 @@
-#pragma once
-
-#include <cassert>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <memory>
 #include <random>
-#include <unordered_map>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "advalgo/bucket_item_feed.hpp"
+#include "advalgo/indexed_item_feed.hpp"
+#include "advalgo/item_feed.hpp"
+#include "advalgo/latency_histogram.hpp"
+#include "advalgo/parse.hpp"
+
 /*
 
 # C. Тындекс.Экспресс
@@ -101,238 +112,446 @@
 поиска, вставки, обновления, удаления в структуре Treap. Актуализация описанных параметров занимает
 O(1).
 
+## Статистика горячих путей
+Цель C_stats собирает то же решение с макросом ADVALGO_ITEM_FEED_STATS: ItemFeed считает глубину
+дерева по операциям, шаги Successor на страницу и глубину рекурсии Split/Merge (подробнее - в
+advalgo/item_feed_stats.hpp). С флагом `--stats` после ответов в stderr печатается сводка.
+
+`--bench` прогоняет типичную нагрузку из условия (редкие добавления и удаления, частые обновления,
+очень частые запросы) в памяти и печатает время на операцию. Сравнение `C --bench` и `C_stats
+--bench` показывает цену статистики, а сборка без макроса не содержит ни одной пробы.
+
+## Проигрывание журналов
+Вход разбирается как журнал операций: читается целиком и разбирается прямо из буфера, без потоков
+ввода, поэтому на записанном с продакшена журнале время уходит на ленту, а не на разбор. С флагом
+`--latency` время каждого вызова ленты (без разбора и печати) записывается в гистограмму его типа
+(LatencyHistogram, в духе HdrHistogram, ошибка около 3%), а после ответов в stderr печатаются
+количество, среднее, p50, p99, p999 и максимум в наносекундах. Вместе с `--index` и `--buckets`
+это позволяет сравнить движки на одном журнале:
+
+```text
+C --latency < trace.txt > /dev/null
+C --buckets --latency < trace.txt > /dev/null
+```
+
+## Индекс для чтения
+С флагом `--index` лента - IndexedItemFeed (advalgo/indexed_item_feed.hpp): поверх Treap строится
+массив id, отсортированный по (score, id), и сжатый индекс границ корзин рейтингов (рейтингов всего
+65536, корзина - товары с одним рейтингом). p position limit становится срезом массива, а g id limit
+- поиском id внутри его корзины и срезом. Изменения идут в Treap сразу, а в массив - через журнал,
+который вливается одним проходом после затишья (когда изменений долго нет). Пока журнал не влит,
+запросы обслуживает Treap, поэтому частые изменения стоят столько же, сколько без индекса.
+
+`C --index --bench` сравнивает Treap и ленту с индексом при разной доле изменений среди запросов.
+
+## Корзины рейтингов
+Рейтинг занимает 16 бит, поэтому с флагом `--buckets` вместо дерева используется BucketItemFeed
+(advalgo/bucket_item_feed.hpp): 65536 корзин с отсортированными id и дерево Фенвика по их размерам.
+Позиция находится спуском по дереву Фенвика, следующая непустая корзина - по битовой маске, а
+обновление - удаление id из одной корзины и вставка в другую без балансировки. Чтобы худший случай
+(все товары с одним рейтингом) не превращал вставку в сдвиг всей корзины, корзина хранится
+кусками не длиннее 256 id.
+
+`C --buckets --bench` сравнивает Treap и корзины на типичной нагрузке при равномерных, степенных,
+узких и одинаковых рейтингах.
+
 */
 
-namespace youndex::express {
+using youndex::express::BucketItemFeed;
+using youndex::express::IndexedItemFeed;
+using youndex::express::Item;
+using youndex::express::ItemFeed;
 
-struct Item {
-  std::uint64_t id;
-  std::uint16_t score;
+struct FeedOperation {
+  char type;
+  uint64_t key;  // id, а для 'p' - позиция
+  uint32_t arg;  // рейтинг или limit
 };
 
-class ItemFeed final {
-public:
-  ItemFeed() : root_(nullptr) {
+// Рейтинг, равномерно распределенный на [1, 65535]
+uint32_t UniformScore(std::mt19937& rng) {
+  return 1 + static_cast<uint32_t>(rng() % 65535);
+}
+
+// Редкие добавления и удаления, частые обновления, очень частые запросы. Первые операции заполняют
+// ленту, чтобы запросы шли по дереву заметного размера
+template <typename Score = uint32_t (*)(std::mt19937&)>
+std::vector<FeedOperation> RandomOperations(
+    size_t count,
+    size_t initial,
+    std::mt19937& rng,
+    Score score = UniformScore
+) {
+  std::vector<FeedOperation> operations;
+  operations.reserve(count);
+  std::vector<uint64_t> alive;
+  uint64_t next_id = 1;
+  for (size_t i = 0; i < count; i++) {
+    const uint32_t kind = rng() % 100;
+    const uint32_t limit = 1 + rng() % 16;
+    if (alive.size() < initial || kind < 5) {
+      alive.push_back(next_id);
+      next_id += 1 + rng() % 8;
+      operations.push_back({'i', alive.back(), score(rng)});
+    } else if (kind < 6) {
+      std::swap(alive[rng() % alive.size()], alive.back());
+      operations.push_back({'r', alive.back(), 0});
+      alive.pop_back();
+    } else if (kind < 26) {
+      const uint32_t new_score = score(rng);
+      operations.push_back({'u', alive[rng() % alive.size()], new_score});
+    } else if (kind < 63) {
+      operations.push_back({'p', rng() % alive.size(), limit});
+    } else {
+      operations.push_back({'g', alive[rng() % alive.size()], limit});
+    }
   }
-  ~ItemFeed() {
-    Clear(root_);
+  return operations;
+}
+
+// Почти только запросы: лента заполняется initial добавлениями, дальше на миллион операций
+// приходится changes_per_million обновлений рейтинга
+std::vector<FeedOperation> ReadMostlyOperations(
+    size_t count,
+    size_t initial,
+    uint32_t changes_per_million,
+    std::mt19937& rng
+) {
+  std::vector<FeedOperation> operations;
+  operations.reserve(initial + count);
+  for (uint64_t id = 1; id <= initial; id++) {
+    operations.push_back({'i', id, 1 + static_cast<uint32_t>(rng() % 65535)});
   }
-
-  [[nodiscard]] std::vector<std::uint64_t> GetAtPosition(std::size_t position, std::size_t limit)
-      const {
-    assert(position < Size());
-    assert(1 <= limit && limit <= 16);
-
-    std::vector<std::uint64_t> result;
-    result.reserve(limit);
-
-    Node* node = Kth(root_, position);
-    for (std::size_t i = 0; i < limit && node != nullptr; ++i) {
-      result.push_back(node->item.id);
-      node = Successor(node);
+  for (size_t i = 0; i < count; i++) {
+    const uint32_t limit = 1 + rng() % 16;
+    if (rng() % 1000000 < changes_per_million) {
+      const auto score = 1 + static_cast<uint32_t>(rng() % 65535);
+      operations.push_back({'u', 1 + rng() % initial, score});
+    } else if (rng() % 2 == 0) {
+      operations.push_back({'p', rng() % initial, limit});
+    } else {
+      operations.push_back({'g', 1 + rng() % initial, limit});
     }
-    return result;
   }
-
-  [[nodiscard]] std::vector<std::uint64_t> GetAtItemWithId(std::uint64_t uid, std::size_t limit)
-      const {
-    assert(Contains(uid));
-    assert(1 <= limit && limit <= 16);
-
-    std::vector<std::uint64_t> result;
-    result.reserve(limit);
-
-    Node* node = id_map_.at(uid);
-    for (std::size_t i = 0; i < limit && node != nullptr; ++i) {
-      result.push_back(node->item.id);
-      node = Successor(node);
+  return operations;
+}
+
+// Возвращает сумму выданных id, чтобы запросы не выбросил оптимизатор
+template <typename Feed>
+uint64_t Apply(Feed& feed, const std::vector<FeedOperation>& operations) {
+  uint64_t checksum = 0;
+  for (const FeedOperation& op : operations) {
+    switch (op.type) {
+      case 'i':
+        feed.Add({op.key, static_cast<uint16_t>(op.arg)});
+        break;
+      case 'u':
+        feed.Update({op.key, static_cast<uint16_t>(op.arg)});
+        break;
+      case 'r':
+        feed.Remove(op.key);
+        break;
+      case 'p':
+        for (const uint64_t id : feed.GetAtPosition(op.key, op.arg)) {
+          checksum += id;
+        }
+        break;
+      default:
+        for (const uint64_t id : feed.GetAtItemWithId(op.key, op.arg)) {
+          checksum += id;
+        }
     }
-    return result;
   }
-
-  void Add(Item item) {
-    assert(!Contains(item.id));
-    root_ = Insert(root_, new Node(item), nullptr);
+  return checksum;
+}
+
+void RunFeedBenchmark() {
+  constexpr size_t Count = 1000000;
+  constexpr size_t Initial = 100000;
+
+  std::mt19937 rng(42);
+  const std::vector<FeedOperation> operations = RandomOperations(Count, Initial, rng);
+
+  double best_ms = 1e18;
+  uint64_t checksum = 0;
+  youndex::express::ItemFeedStats stats;
+  for (int32_t i = 0; i < 3; i++) {
+    ItemFeed feed;
+    const auto start = std::chrono::steady_clock::now();
+    checksum = Apply(feed, operations);
+    const auto finish = std::chrono::steady_clock::now();
+    best_ms = std::min(best_ms, std::chrono::duration<double, std::milli>(finish - start).count());
+    stats = feed.Stats();
   }
-
-  void Update(Item item) {
-    assert(Contains(item.id));
-    Remove(item.id);
-    Add(item);
+  std::printf(
+      "ops=%zu stats=%s time=%8.2fms ns/op=%.1f checksum=%llu\n",
+      Count,
+      youndex::express::stats::Enabled ? "on" : "off",
+      best_ms,
+      best_ms * 1e6 / Count,
+      static_cast<unsigned long long>(checksum)
+  );
+  // Счетчики потока общие для всех лент, поэтому сводка накоплена за все прогоны
+  stats.Dump(stdout);
+}
+
+// Запросы при редких изменениях: Treap против IndexedItemFeed. Для каждой доли изменений
+// печатается время на операцию (вместе с заполнением ленты) и количество вливаний журнала
+void RunIndexBenchmark() {
+  constexpr size_t Count = 1000000;
+  constexpr size_t Initial = 100000;
+
+  for (const uint32_t changes_per_million : {0U, 10U, 100U, 1000U, 10000U}) {
+    std::mt19937 rng(42);
+    const std::vector<FeedOperation> operations =
+        ReadMostlyOperations(Count, Initial, changes_per_million, rng);
+
+    auto run = [&](const char* engine, auto& feed) {
+      const auto start = std::chrono::steady_clock::now();
+      const uint64_t checksum = Apply(feed, operations);
+      const auto finish = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+      std::printf("changes/1e6=%-5u %-7s time=%8.2fms ns/op=%.1f checksum=%llu",
+                  changes_per_million, engine, ms, ms * 1e6 / operations.size(),
+                  static_cast<unsigned long long>(checksum));
+    };
+
+    ItemFeed treap;
+    run("treap", treap);
+    std::printf("\n");
+    IndexedItemFeed indexed;
+    run("indexed", indexed);
+    std::printf(" merges=%zu index=%.2fMB\n", indexed.Merges(), indexed.IndexMemoryBytes() / 1e6);
   }
+}
 
-  void Remove(std::uint64_t uid) {
-    assert(Contains(uid));
-    Item key = id_map_.at(uid)->item;
-    root_ = Erase(root_, key);
-  }
+// Treap против BucketItemFeed на типичной нагрузке из условия при разных распределениях рейтинга,
+// включая худший для корзин случай - все товары с одним рейтингом
+void RunBucketBenchmark() {
+  constexpr size_t Count = 1000000;
+  constexpr size_t Initial = 100000;
 
-private:
-  struct Node {
-    Item item;
-    Node* left = nullptr;
-    Node* right = nullptr;
-    Node* parent = nullptr;
-    std::size_t subtree_size = 1;
-    int priority;
-    explicit Node(const Item& it) : item(it), priority(rand_dist(rand_eng)) {
-    }
+  struct Distribution {
+    const char* name;
+    uint32_t (*score)(std::mt19937&);
+  };
+  const Distribution distributions[] = {
+      {"uniform", UniformScore},
+      // Степенное: большинство товаров с маленьким (хорошим) рейтингом
+      {"skewed",
+       [](std::mt19937& rng) {
+         const double u = std::uniform_real_distribution<double>(0, 1)(rng);
+         return 1 + static_cast<uint32_t>(65534 * std::pow(u, 4));
+       }},
+      // Узкое: почти все рейтинги в паре сотен значений около середины
+      {"narrow",
+       [](std::mt19937& rng) {
+         const double score = std::normal_distribution<double>(32768, 50)(rng);
+         return static_cast<uint32_t>(std::clamp(score, 1.0, 65535.0));
+       }},
+      {"one_bucket", [](std::mt19937&) { return 1U; }},
   };
 
-  Node* root_;
-  std::unordered_map<std::uint64_t, Node*> id_map_;
-
-  static bool KeyLess(const Item& a, const Item& b) {
-    return a.score != b.score ? a.score < b.score : a.id < b.id;
+  for (const Distribution& distribution : distributions) {
+    std::mt19937 rng(42);
+    const std::vector<FeedOperation> operations =
+        RandomOperations(Count, Initial, rng, distribution.score);
+
+    auto run = [&](const char* engine, auto make_feed) {
+      double best_ms = 1e18;
+      uint64_t checksum = 0;
+      for (int32_t i = 0; i < 3; i++) {
+        auto feed = make_feed();
+        const auto start = std::chrono::steady_clock::now();
+        checksum = Apply(*feed, operations);
+        const auto finish = std::chrono::steady_clock::now();
+        best_ms =
+            std::min(best_ms, std::chrono::duration<double, std::milli>(finish - start).count());
+      }
+      std::printf("%-10s %-7s time=%8.2fms ns/op=%.1f checksum=%llu\n", distribution.name, engine,
+                  best_ms, best_ms * 1e6 / Count, static_cast<unsigned long long>(checksum));
+    };
+
+    run("treap", [] { return std::make_unique<ItemFeed>(); });
+    run("buckets", [] { return std::make_unique<BucketItemFeed>(); });
   }
+}
 
-  static bool KeyEqual(const Item& a, const Item& b) {
-    return a.score == b.score && a.id == b.id;
-  }
+// Задержки вызовов ленты по типам операций, в наносекундах
+struct FeedLatencies {
+  static constexpr const char* Names[] = {"add", "update", "remove", "at_position", "at_id"};
 
-  [[nodiscard]] bool Contains(std::uint64_t uid) const {
-    return id_map_.find(uid) != id_map_.end();
-  }
+  LatencyHistogram histograms[std::size(Names)];
 
-  [[nodiscard]] std::size_t Size() const {
-    return SubtreeSize(root_);
+  void Dump(std::FILE* out) const {
+    for (size_t op = 0; op < std::size(Names); op++) {
+      histograms[op].Dump(out, Names[op]);
+    }
   }
+};
 
-  static std::size_t SubtreeSize(const Node* n) {
-    return n ? n->subtree_size : 0;
-  }
+// Записывает время от создания до разрушения в гистограмму операции op, если latencies не nullptr
+class OperationTimer {
+  FeedLatencies* latencies_;
+  size_t op_;
+  std::chrono::steady_clock::time_point start_;
 
-  static void Update(Node* n) {
-    if (!n)
-      return;
-    n->subtree_size = 1 + SubtreeSize(n->left) + SubtreeSize(n->right);
-    if (n->left)
-      n->left->parent = n;
-    if (n->right)
-      n->right->parent = n;
+public:
+  OperationTimer(FeedLatencies* latencies, size_t op) : latencies_(latencies), op_(op) {
+    if (latencies_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
   }
 
-  // Treap split/merge
-  static void Split(Node* t, const Item& key, Node*& left, Node*& right) {
-    if (!t) {
-      left = right = nullptr;
+  ~OperationTimer() {
+    if (latencies_ == nullptr) {
       return;
     }
-    if (KeyLess(t->item, key) || KeyEqual(t->item, key)) {
-      Split(t->right, key, t->right, right);
-      left = t;
-    } else {
-      Split(t->left, key, left, t->left);
-      right = t;
-    }
-    Update(t);
+    const auto elapsed = std::chrono::steady_clock::now() - start_;
+    latencies_->histograms[op_].Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+    ));
   }
+};
 
-  static Node* Merge(Node* left, Node* right) {
-    if (!left)
-      return right;
-    if (!right)
-      return left;
-    if (left->priority > right->priority) {
-      left->right = Merge(left->right, right);
-      Update(left);
-      return left;
-    } else {
-      right->left = Merge(left, right->left);
-      Update(right);
-      return right;
+// Проигрывает журнал операций из [ptr, end) в формате входа и возвращает ответы. Если latencies не
+// nullptr, время каждого вызова ленты (без разбора и печати) записывается в гистограмму его типа
+template <typename Feed>
+std::string Replay(Feed& feed, const char* ptr, const char* end, FeedLatencies* latencies) {
+  std::string output = "Started\n";
+  output.reserve(static_cast<size_t>(end - ptr) * 2);
+
+  auto append_ids = [&output](const std::vector<uint64_t>& ids) {
+    output += '[';
+    char buffer[24];
+    for (const uint64_t id : ids) {
+      output.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), id).ptr);
+      output += ", ";
     }
-  }
+    output += "]\n";
+  };
 
-  Node* Insert(Node* root, Node* node, Node* parent) {
-    if (!root) {
-      node->parent = parent;
-      id_map_[node->item.id] = node;
-      return node;
-    }
-    if (node->priority > root->priority) {
-      Split(root, node->item, node->left, node->right);
-      node->parent = parent;
-      if (node->left)
-        node->left->parent = node;
-      if (node->right)
-        node->right->parent = node;
-      Update(node);
-      id_map_[node->item.id] = node;
-      return node;
-    } else if (KeyLess(node->item, root->item)) {
-      root->left = Insert(root->left, node, root);
+  for (uint64_t n = ReadNumber(ptr, end); n > 0; n--) {
+    const char op = ReadOp(ptr, end);
+
+    if (op == 'i') {
+      const uint64_t id = ReadNumber(ptr, end);
+      const Item item{id, static_cast<uint16_t>(ReadNumber(ptr, end))};
+      {
+        const OperationTimer timer(latencies, 0);
+        feed.Add(item);
+      }
+      output += "Added\n";
+    } else if (op == 'u') {
+      const uint64_t id = ReadNumber(ptr, end);
+      const Item item{id, static_cast<uint16_t>(ReadNumber(ptr, end))};
+      {
+        const OperationTimer timer(latencies, 1);
+        feed.Update(item);
+      }
+      output += "Updated\n";
+    } else if (op == 'r') {
+      const uint64_t id = ReadNumber(ptr, end);
+      {
+        const OperationTimer timer(latencies, 2);
+        feed.Remove(id);
+      }
+      output += "Removed\n";
+    } else if (op == 'p') {
+      const uint64_t position = ReadNumber(ptr, end);
+      const uint64_t limit = ReadNumber(ptr, end);
+      std::vector<uint64_t> ids;
+      {
+        const OperationTimer timer(latencies, 3);
+        ids = feed.GetAtPosition(position, limit);
+      }
+      output += "AtPos: ";
+      append_ids(ids);
     } else {
-      root->right = Insert(root->right, node, root);
+      const uint64_t id = ReadNumber(ptr, end);
+      const uint64_t limit = ReadNumber(ptr, end);
+      std::vector<uint64_t> ids;
+      {
+        const OperationTimer timer(latencies, 4);
+        ids = feed.GetAtItemWithId(id, limit);
+      }
+      output += "AtId: ";
+      append_ids(ids);
     }
-    Update(root);
-    return root;
   }
-
-  Node* Erase(Node* root, const Item& key) {
-    if (!root)
-      return nullptr;
-    if (KeyEqual(root->item, key)) {
-      id_map_.erase(root->item.id);
-      Node* merged = Merge(root->left, root->right);
-      if (merged)
-        merged->parent = root->parent;
-      delete root;
-      return merged;
-    } else if (KeyLess(key, root->item)) {
-      root->left = Erase(root->left, key);
-      if (root->left)
-        root->left->parent = root;
-    } else {
-      root->right = Erase(root->right, key);
-      if (root->right)
-        root->right->parent = root;
+  return output;
+}
+
+// Проигрывает вход на ленте Feed, печатает ответы и, если нужно, отчет о задержках в stderr
+template <typename Feed>
+void ReplayInput(Feed& feed, const std::string& input, bool report_latency) {
+  FeedLatencies latencies;
+  std::cout << Replay(feed, input.data(), input.data() + input.size(),
+                      report_latency ? &latencies : nullptr);
+  if (report_latency) {
+    std::cout.flush();
+    latencies.Dump(stderr);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  bool bench = false;
+  bool print_stats = false;
+  bool index = false;
+  bool buckets = false;
+  bool latency = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--stats") {
+      print_stats = true;
+    } else if (arg == "--index") {
+      index = true;
+    } else if (arg == "--buckets") {
+      buckets = true;
+    } else if (arg == "--latency") {
+      latency = true;
     }
-    Update(root);
-    return root;
   }
 
-  static Node* Kth(Node* root, std::size_t k) {
-    if (!root)
-      return nullptr;
-    std::size_t left_size = SubtreeSize(root->left);
-    if (k < left_size)
-      return Kth(root->left, k);
-    else if (k == left_size)
-      return root;
-    else
-      return Kth(root->right, k - left_size - 1);
+  if (bench && buckets) {
+    RunBucketBenchmark();
+    return 0;
   }
-
-  // Successor using parent pointers
-  static Node* Successor(Node* node) {
-    if (!node)
-      return nullptr;
-    if (node->right) {
-      node = node->right;
-      while (node->left)
-        node = node->left;
-      return node;
-    }
-    Node* parent = node->parent;
-    while (parent && node == parent->right) {
-      node = parent;
-      parent = parent->parent;
-    }
-    return parent;
+  if (bench && index) {
+    RunIndexBenchmark();
+    return 0;
+  }
+  if (bench) {
+    RunFeedBenchmark();
+    return 0;
   }
 
-  static void Clear(Node* node) {
-    if (!node)
-      return;
-    Clear(node->left);
-    Clear(node->right);
-    delete node;
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
+  // Вход читается целиком и разбирается прямо из буфера
+  const std::string input(std::istreambuf_iterator<char>(std::cin), {});
+
+  if (index) {
+    IndexedItemFeed feed;
+    ReplayInput(feed, input, latency);
+    return 0;
+  }
+  if (buckets) {
+    BucketItemFeed feed;
+    ReplayInput(feed, input, latency);
+    return 0;
   }
 
-  // Random engine for treap priority
-  static inline std::mt19937 rand_eng{std::random_device{}()};
-  static inline std::uniform_int_distribution<int> rand_dist{1, 1'000'000'000};
-};
+  ItemFeed feed;
+  ReplayInput(feed, input, latency);
+
+  if (print_stats) {
+    std::cout.flush();
+    feed.Stats().Dump(stderr);
+  }
 
-}  // namespace youndex::express
+  return 0;
+}
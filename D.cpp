@@ -1,6 +1,9 @@
 #include <iostream>
+#include <string>
 #include <vector>
 
+#include "advalgo/some_array.hpp"
+
 /*
 
 # D. Алгособес
@@ -59,31 +62,6 @@ TBD
 
 */
 
-struct Node {
-  int64_t value;
-  int64_t sum;
-  size_t size;
-  uint16_t score;
-  Node *left, *right;
-  Node(int64_t v = 0, uint16_t p = 0)
-      : value(v), sum(v), size(1), score(p), left(nullptr), right(nullptr) {
-  }
-};
-
-class SomeArray {
-public:
-  explicit SomeArray(const std::vector<int32_t>& source) {
-    // TODO: implement
-  }
-  void Swap(size_t x, size_t y) {
-    // TODO: implement
-  }
-  int64_t CalculateSum(size_t a, size_t b) {
-    // TODO: implement
-    return 0;
-  }
-};
-
 int main() {
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
@@ -1,8 +1,17 @@
-#include <array>
-#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "advalgo/tree.hpp"
+#include "advalgo/xor_path.hpp"
+#include "advalgo/xor_trie.hpp"
+
 /*
 
 # E. Фарид и ХOR такси
@@ -59,8 +68,9 @@ xor-расстояния. Если предположить, что мы зна
 Первый этап будем решать обходом графа в ширину от вершины f. Поскольку путь до каждой вершины
 единственный и уникальный, то для каждой пройденной вершины запомним одно число - xor между
 значениями длин дорог от вершины f до текущей вершины. При итерации по соседям для определенной
-вершины, посчитаем описанное значение (если оно уже не посчитано) и запомним его. Для вершины f это
-значение примем равным 0.
+вершины, посчитаем описанное значение (если это не родитель) и запомним его. Для вершины f это
+значение примем равным 0. Обход выполняется общим модулем advalgo/tree.hpp по плоским массивам
+смежности.
 
 Второй этап будем решать при помощи префиксного дерева (trie). Каждая вершина будет представлять
 один из порядковых битов числа (1 или 0) и иметь максимум два ребенка. Чтобы покрыть все значения
@@ -76,110 +86,277 @@ xor-расстояния. Если предположить, что мы зна
 максимальное xor-значение с выбранным. Остается только получить это xor-значение и найти
 максимальное среди всех.
 
+## Сжатое префиксное дерево
+Обычное префиксное дерево содержит по 31 вершине на каждое число (около 6 млн вершин при
+n = 200000), растет по одной вершине через push_back и ветвится на каждом бите при поиске.
+Поскольку все значения известны заранее, вместо него строится сжатое дерево (PATRICIA): значения
+сортируются, убираются повторы, и рекурсивно создаются только вершины ветвления - старший бит, в
+котором различаются значения отрезка, делит его на две части. Цепочки вершин с единственным ребенком
+исчезают, для k различных значений получается ровно k - 1 внутренняя вершина, поэтому память
+выделяется один раз.
+
+У каждой внутренней вершины есть оба ребенка, значит при поиске максимального xor всегда можно
+перейти в ребенка с противоположным битом: переход выполняется без условий, индексом
+child[bit ^ 1]. Биты между вершинами ветвления у всех значений поддерева совпадают и на выбор не
+влияют.
+
+## Поиск без префиксного дерева
+Второй этап можно решить вовсе без дерева (`--engine sort`). Значения сортируются поразрядно (два
+прохода по 15 бит), после чего отрезок значений с общим префиксом делится по очередному биту на
+половины 0 и 1. Если обе половины непусты, ответ содержит этот бит, и дальше достаточно рекурсивно
+сочетать противоположные половины двух отрезков: (A0, B1) и (A1, B0), а если таких пар нет -
+(A0, B0) или (A1, B1). Дополнительная память O(n) вместо O(31 n) вершин дерева, а обращения к памяти
+последовательные.
+
+## Параллельный поиск
+Для десятков миллионов значений оба этапа работы с деревом выполняются параллельно. Значения
+раскладываются по 256 корзинам по старшим 8 битам (каждый поток считает и раскладывает свой кусок),
+для каждой непустой корзины в отдельном потоке строится свое сжатое дерево. Над номерами непустых
+корзин строится маленькое дерево верхнего уровня: старшие биты важнее младших, поэтому для запроса
+сначала выбирается корзина с наибольшим xor старших бит, а затем поиск продолжается в ее дереве.
+Готовые деревья только читаются, поэтому запросы делятся между потоками на непрерывные куски, а
+ответы сводятся максимумом. Число потоков задается аргументом `--threads K` (по умолчанию
+std::thread::hardware_concurrency()).
+
+## Много магазинов
+Режим `--service` отвечает на запросы для многих магазинов по одному дереву. Формат ввода: n, n - 1
+ребер в формате условия, затем число запросов q и q номеров f; на каждый запрос выводится ответ.
+Если val - xor-расстояния от любого фиксированного корня, то xor-dist(x, f) ^ xor-dist(f, y) =
+val[x] ^ val[y], то есть магазин лишь запрещает выбирать вершину f. BFS выполняется один раз от
+вершины 1, все val добавляются в префиксное дерево со счетчиками в вершинах и один раз ищется лучшая
+пара (a, b). Для f не из этой пары ответ равен глобальному максимуму, а для f = a и f = b значение f
+заранее удаляется из дерева и поиск повторяется. Каждый запрос - O(1) после O(n log C) предподсчета.
+`--service --bench` сравнивает этот режим с BFS и деревом на каждый запрос (порядок флагов не
+важен).
+
+Аргумент `--bench [n...]` сравнивает количество вершин, память и время обоих деревьев и сортировки
+(по умолчанию для n = 200000 и n = 10^8), а также параллельное дерево для числа потоков от 1 до K.
+
 ## Асимптотика решения
-Время: O(n)
+Время: O(n log n)
 Память: O(n)
 
 */
 
-int main() {
-  std::ios::sync_with_stdio(false);
-  std::cin.tie(nullptr);
+// Граф читается в формате условия: n - 1 строк "u v w", вершины нумеруются с 1 (вершина 0 не
+// используется)
+Tree ReadTree(int32_t n) {
+  std::vector<Edge> edges(n - 1);
+  for (auto& e : edges) {
+    std::cin >> e.u >> e.v >> e.w;
+  }
+  return {n + 1, edges};
+}
 
-  int32_t n, f;
-  std::cin >> n >> f;
+// Случайное дерево из n вершин с весами до 10^9
+Tree RandomTree(int32_t n, std::mt19937& rng) {
+  std::vector<Edge> edges;
+  edges.reserve(n - 1);
+  for (int32_t v = 2; v <= n; v++) {
+    const auto u = static_cast<int32_t>(rng() % (v - 1)) + 1;
+    const auto w = static_cast<int32_t>(rng() % 1000000000) + 1;
+    edges.push_back({u, v, w});
+  }
+  return {n + 1, edges};
+}
 
-  // adjacency list
-  std::vector<std::vector<std::pair<int32_t, int32_t>>> adj(n + 1);
+// Сравнение сервиса для многих магазинов с решением "BFS + дерево" для каждого магазина
+void RunServiceBenchmark(uint32_t threads) {
+  constexpr int32_t N = 200000;
+  constexpr int32_t Q = 100000;
+  constexpr int32_t NaiveQ = 20;
+
+  std::mt19937 rng(42);
+  const Tree tree = RandomTree(N, rng);
+  std::vector<int32_t> shops(Q);
+  for (auto& f : shops) {
+    f = static_cast<int32_t>(rng() % N) + 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const XorPathService service(tree);
+  auto finish = std::chrono::steady_clock::now();
+  const double build_ms = std::chrono::duration<double, std::milli>(finish - start).count();
 
-  for (int32_t i = 0; i < n - 1; ++i) {
-    int32_t u, v, w;
-    std::cin >> u >> v >> w;
-    adj[u].push_back({v, w});
-    adj[v].push_back({u, w});
+  int64_t checksum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int32_t f : shops) {
+    checksum += service.Answer(f);
   }
+  finish = std::chrono::steady_clock::now();
+  const double query_ns = std::chrono::duration<double, std::nano>(finish - start).count() / Q;
 
-  // BFS to compute XOR distances from f
-  std::vector<int32_t> val(n + 1, 0);
-  std::vector<bool> used(n + 1, false);
-  std::deque<int32_t> dq;
-
-  dq.push_back(f);
-  used[f] = true;
-
-  while (!dq.empty()) {
-    int32_t u = dq.front();
-    dq.pop_front();
-
-    for (const auto& e : adj[u]) {
-      int32_t v = e.first;
-      int32_t w = e.second;
-      if (!used[v]) {
-        used[v] = true;
-        val[v] = val[u] ^ w;
-        dq.push_back(v);
-      }
-    }
+  bool mismatch = false;
+  start = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i < NaiveQ; i++) {
+    mismatch |= SolveForShop(tree, shops[i], threads, false) != service.Answer(shops[i]);
   }
+  finish = std::chrono::steady_clock::now();
+  const double naive_ms =
+      std::chrono::duration<double, std::milli>(finish - start).count() / NaiveQ;
+
+  std::printf("n=%d q=%d checksum=%lld\n", N, Q, static_cast<long long>(checksum));
+  std::printf("service: build=%.2fms query=%.1fns total=%.2fms\n", build_ms, query_ns,
+              build_ms + query_ns * Q / 1e6);
+  std::printf("bfs + trie per shop: %.2fms/query, ~%.0fms for q=%d\n", naive_ms, naive_ms * Q, Q);
+  if (mismatch) {
+    std::printf("result mismatch\n");
+  }
+}
 
-  // Collect all XOR-values except node f
-  std::vector<int32_t> A;
-  A.reserve(static_cast<size_t>(n - 1));
-  for (int32_t v = 1; v <= n; ++v) {
-    if (v == f) {
-      continue;
-    }
-    A.push_back(val[v]);
+// Сравнение движков поиска максимального xor пары на n случайных 30-битных значениях
+void RunBenchmark(size_t n, uint32_t max_threads) {
+  // Несжатое дерево на больших n занимает десятки гигабайт
+  constexpr size_t BitTrieMaxN = 1000000;
+
+  std::mt19937 rng(42);
+  std::vector<int32_t> values(n);
+  for (auto& value : values) {
+    value = static_cast<int32_t>(rng() & ((1U << MaxBit) - 1));
   }
 
-  // Bitwise trie for max xor pair
-  constexpr int32_t MAXB = 30;
-
-  std::vector<std::array<int32_t, 2>> trie;
-  trie.push_back({-1, -1});  // root
-
-  auto trie_insert = [&](int32_t x) {
-    int32_t node = 0;
-    for (int32_t b = MAXB; b >= 0; --b) {
-      int32_t bit = (x >> b) & 1;
-      if (trie[node][bit] == -1) {
-        trie[node][bit] = static_cast<int32_t>(trie.size());
-        trie.push_back({-1, -1});
-      }
-      node = trie[node][bit];
-    }
+  std::printf("n=%zu\n", n);
+
+  auto report = [n](const char* name, size_t nodes, size_t memory, double build_ms, double ms) {
+    std::printf(
+        "%-16s nodes=%zu memory=%zuKB build=%.2fms query=%.1fns/value\n",
+        name,
+        nodes,
+        memory / 1024,
+        build_ms,
+        ms * 1e6 / static_cast<double>(n)
+    );
+  };
+
+  auto elapsed_ms = [](auto start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
   };
 
-  auto trie_max_xor_with = [&](int32_t x) -> int32_t {
-    int32_t node = 0;
-    int32_t res = 0;
-    for (int32_t b = MAXB; b >= 0; --b) {
-      int32_t bit = (x >> b) & 1;
-      int32_t want = bit ^ 1;
-      if (trie[node][want] != -1) {
-        res |= (1 << b);
-        node = trie[node][want];
-      } else {
-        node = trie[node][bit];
-      }
+  int32_t expected = -1;
+  auto check = [&expected](int32_t answer) {
+    if (expected != -1 && expected != answer) {
+      std::printf("result mismatch\n");
     }
-    return res;
+    expected = answer;
   };
 
-  // Insert all values
-  for (int32_t x : A) {
-    trie_insert(x);
+  if (n <= BitTrieMaxN) {
+    auto start = std::chrono::steady_clock::now();
+    BitTrie trie;
+    for (int32_t x : values) {
+      trie.Insert(x);
+    }
+    const double build_ms = elapsed_ms(start);
+
+    int32_t answer = 0;
+    start = std::chrono::steady_clock::now();
+    for (int32_t x : values) {
+      answer = std::max(answer, trie.MaxXorWith(x));
+    }
+    report("trie", trie.NodeCount(), trie.MemoryBytes(), build_ms, elapsed_ms(start));
+    check(answer);
   }
 
-  // Compute answer
-  int32_t answer = 0;
-  for (int32_t x : A) {
-    int32_t cur = trie_max_xor_with(x);
-    if (cur > answer) {
-      answer = cur;
+  {
+    auto start = std::chrono::steady_clock::now();
+    const CompressedTrie trie(values);
+    const double build_ms = elapsed_ms(start);
+
+    int32_t answer = 0;
+    start = std::chrono::steady_clock::now();
+    for (int32_t x : values) {
+      answer = std::max(answer, trie.MaxXorWith(x));
     }
+    report("compressed trie", trie.NodeCount(), trie.MemoryBytes(), build_ms, elapsed_ms(start));
+    check(answer);
   }
 
-  std::cout << answer << "\n";
+  {
+    auto start = std::chrono::steady_clock::now();
+    const SortedXorSet sorted(values);
+    const double build_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    const int32_t answer = sorted.MaxXorPair();
+    report("radix sort + d&c", 0, sorted.MemoryBytes(), build_ms, elapsed_ms(start));
+    check(answer);
+  }
+
+  for (uint32_t threads = 1; threads <= max_threads; threads++) {
+    auto start = std::chrono::steady_clock::now();
+    const ParallelXorTrie trie(values, threads);
+    const double build_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    const int32_t answer = trie.MaxXorPair(values, threads);
+    const std::string name = "parallel trie x" + std::to_string(threads);
+    report(name.c_str(), trie.NodeCount(), trie.MemoryBytes(), build_ms, elapsed_ms(start));
+    check(answer);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  bool sort_engine = false;
+  bool service = false;
+  bool bench = false;
+  std::vector<size_t> sizes;  // размеры n для --bench
+  uint32_t threads = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--engine" && i + 1 < argc) {
+      sort_engine = std::string(argv[++i]) == "sort";
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::max<uint32_t>(std::stoul(argv[++i]), 1);
+    } else if (arg == "--service") {
+      service = true;
+    } else if (bench && !arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos) {
+      sizes.push_back(std::stoull(arg));
+    }
+  }
+
+  if (bench && service) {
+    RunServiceBenchmark(threads);
+    return 0;
+  }
+  if (bench) {
+    if (sizes.empty()) {
+      sizes = {200000, 100000000};
+    }
+    for (size_t n : sizes) {
+      RunBenchmark(n, threads);
+    }
+    return 0;
+  }
+
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
+  if (service) {
+    int32_t n;
+    std::cin >> n;
+    const Tree tree = ReadTree(n);
+    const XorPathService paths(tree);
+
+    int32_t q;
+    std::cin >> q;
+    std::string output;
+    while (q-- > 0) {
+      int32_t f;
+      std::cin >> f;
+      output += std::to_string(paths.Answer(f)) + '\n';
+    }
+    std::cout << output;
+    return 0;
+  }
+
+  int32_t n, f;
+  std::cin >> n >> f;
+
+  const Tree tree = ReadTree(n);
+
+  std::cout << SolveForShop(tree, f, threads, sort_engine) << "\n";
   return 0;
 }
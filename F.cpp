@@ -1,6 +1,29 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "advalgo/ribbon.hpp"
+
 /*
 
 # F. Праздничная лента
@@ -58,51 +81,550 @@ t_i также состоит из латинских букв, которые 
 Если слова кончились к концу ленты или в середине ленты, то завершаем цикл и выводим "YES". Иначе
 "NO".
 
+## Векторный поиск символа
+Два указателя большую часть времени просто ищут в ленте следующее вхождение текущей буквы слова.
+Этот поиск вынесен в FindByte: лента сравнивается с буквой блоками по 16 (SSE2), 64 (две загрузки
+AVX2 или одна AVX-512) байт, результат сравнения сворачивается в битовую маску, а позиция первого
+совпадения - count trailing zeros маски. Хвост короче блока досматривается скалярным циклом.
+Версия выбирается один раз при первом вызове по возможностям процессора (__builtin_cpu_supports),
+на других архитектурах используется скалярный цикл. Тот же поиск используется в потоковом режиме.
+
+`--bench` сравнивает исходный цикл, скалярную, SSE2, AVX2, AVX-512 версии и std::memchr на ленте
+из 10^8 символов: случайной (52 буквы, совпадение в среднем через 52 символа) и из строчных букв со
+словами из редких заглавных.
+
+## Много запросов к одной ленте
+Режим `--multi` отвечает на много списков слов для одной длинной ленты. Формат ввода: в первой
+строке n и q, во второй - лента s, далее q строк вида "m t_1 t_2 ... t_m"; для каждой строки
+выводится YES или NO. Если лента короче n или в ней есть не латинские буквы, программа завершается
+с ошибкой.
+
+Для ленты строится индекс следующего вхождения: для позиции p и буквы c он за O(1) находит первое
+вхождение c в s, начиная с p. Тогда каждое слово сопоставляется прыжками по вхождениям своих букв за
+O(|t_i|), без просмотра ленты между ними. Полная таблица n x 52 для n = 10^7 заняла бы 2 ГБ, поэтому
+она хранится в два уровня: для каждого блока из 64 позиций и каждой буквы - битовая маска вхождений
+буквы в блоке и номер ближайшего блока (не раньше текущего), где буква встречается. Поиск - маска
+текущего блока с отброшенными младшими битами и count trailing zeros, а если в блоке буквы нет -
+один переход по номеру блока. Индекс занимает около 13 байт на символ ленты.
+
+Ленту можно добавлять кусками (RibbonIndex::Append): номера ближайших блоков заполняются вперед,
+как только буква встречается, а запросы отвечают по уже полученной части ленты.
+
+`--multi --bench` сравнивает индекс с двумя указателями на ленте из 10^7 символов для 10^3 - 10^5
+слов.
+
+## Потоковый режим
+Для лент в несколько гигабайт хранить ленту и все слова в памяти не нужно: лента просматривается
+один раз слева направо, а из слов нужно только текущее. Слова во входе идут после ленты, но их
+смещение известно заранее (заголовок, затем ровно n символов ленты), поэтому файл читается двумя
+независимыми курсорами: один по ленте, второй по словам.
+
+- `--mmap FILE` отображает файл в память. Лента подается сопоставителю кусками по 4 МБ, уже
+  просмотренные страницы освобождаются через madvise(MADV_DONTNEED), слово - это string_view прямо
+  в отображении.
+- `--stream [FILE]` читает файл (или stdin, если это обычный файл) через pread кусками по 4 МБ.
+  Следующий кусок читается в отдельном потоке, пока сканируется текущий. Слова читаются своим
+  буфером на 64 КБ, в памяти хранится только текущее слово. Если stdin - не файл (например, канал),
+  то вход читается в память целиком и дальше обрабатывается как в режиме `--mmap`.
+
+Состояние сопоставителя (текущее слово, позиция в нем, нужно ли пропустить первый символ следующего
+куска) переносится между кусками, поэтому границы кусков на ответ не влияют. Пиковая память -
+O(размер куска + длина самого длинного слова). Если слова кончились раньше, чем были найдены все m,
+то программа завершается с ошибкой, а не считает список полным.
+
+`--stream --bench [GB]` генерирует файл с лентой заданного размера (по умолчанию 1 ГБ) и для
+каждого способа чтения в отдельном процессе печатает время, пропускную способность и пиковую память.
+
 ## Асимптотика решения
-Время: O(n)
+Время: O(n), в режиме `--multi` - O(n * 52 / 64) на индекс и O(sum |t_i|) на запрос
 Память: O(n)
 
 */
 
-int main() {
-  std::ios::sync_with_stdio(false);
-  std::cin.tie(nullptr);
+void RunScanBenchmark() {
+  constexpr size_t N = 100000000;
+  constexpr int32_t Queries = 5;
 
-  int32_t n, m;
-  std::cin >> n >> m;
+  auto elapsed_ms = [](auto start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
 
-  std::string s;
-  std::cin >> s;
+  struct Engine {
+    const char* name;
+    FindByteFn find;
+  };
+  std::vector<Engine> engines = {
+      {"scalar", FindByteScalar},
+      {"memchr",
+       [](const char* data, size_t size, size_t pos, char c) -> size_t {
+         const void* found = std::memchr(data + pos, c, size - pos);
+         return found != nullptr ? static_cast<const char*>(found) - data : ByteNotFound;
+       }},
+  };
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  engines.push_back({"sse2", FindByteSse2});
+  if (__builtin_cpu_supports("avx2")) {
+    engines.push_back({"avx2", FindByteAvx2});
+  }
+  if (__builtin_cpu_supports("avx512bw")) {
+    engines.push_back({"avx512", FindByteAvx512});
+  }
+#endif
 
-  std::vector<std::string> words(m);
-  for (int i = 0; i < m; i++) {
-    std::cin >> words[i];
+  std::mt19937 rng(42);
+  for (const bool skewed : {false, true}) {
+    // random: 52 буквы равновероятно, следующая нужная буква в среднем через 52 символа.
+    // skewed: лента из строчных букв, слова - из редких заглавных, расставленных равномерно
+    std::string s(N, ' ');
+    for (auto& ch : s) {
+      const bool lower = skewed || rng() % 2 == 0;
+      ch = static_cast<char>(lower ? 'a' + rng() % 26 : 'A' + rng() % 26);
+    }
+    const size_t total = skewed ? 1000 : N / 64;
+    std::vector<std::string> words;
+    for (size_t planted = 0; planted < total;) {
+      std::string word;
+      for (size_t length = 1 + rng() % 8; length > 0 && planted < total; length--) {
+        const bool upper = skewed || rng() % 2 == 0;
+        word += static_cast<char>(upper ? 'A' + rng() % 26 : 'a' + rng() % 26);
+        if (skewed) {
+          s[planted * (N / total)] = word.back();
+        }
+        planted++;
+      }
+      words.push_back(std::move(word));
+    }
+
+    std::printf("%s ribbon n=%zu, %zu words:\n", skewed ? "skewed" : "random", N, words.size());
+
+    bool expected = false;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < Queries; i++) {
+      expected = MatchesGreedy(s, words);
+    }
+    const double greedy_ms = elapsed_ms(start) / Queries;
+    std::printf("  %-8s %8.2fms %7.2fGB/s\n", "loop", greedy_ms, N / greedy_ms / 1e6);
+
+    for (const Engine& engine : engines) {
+      auto find = [&engine](std::string_view ribbon, size_t pos, char c) {
+        return pos < ribbon.size() ? engine.find(ribbon.data(), ribbon.size(), pos, c)
+                                   : ByteNotFound;
+      };
+      bool result = false;
+      start = std::chrono::steady_clock::now();
+      for (int32_t i = 0; i < Queries; i++) {
+        result = MatchesScan(s, words, find);
+      }
+      const double ms = elapsed_ms(start) / Queries;
+      std::printf(
+          "  %-8s %8.2fms %7.2fGB/s %5.2fx%s\n",
+          engine.name,
+          ms,
+          N / ms / 1e6,
+          greedy_ms / ms,
+          result == expected ? "" : " result mismatch"
+      );
+    }
   }
+}
 
-  size_t word_idx = 0;  // index of current word
-  std::string& word = words[word_idx];
-  size_t w_ptr = 0;  // pointer inside words[w]
+// Ответы на запросы режима --multi
+void AnswerMulti() {
+  size_t n, q;
+  std::cin >> n >> q;
 
-  for (size_t s_ptr = 0; s_ptr < s.length(); s_ptr++) {
-    if (s[s_ptr] == word[w_ptr]) {
-      w_ptr++;
+  // Ленту читаем кусками, не храня ее целиком
+  RibbonIndex index;
+  std::cin >> std::ws;
+  std::string chunk(1 << 16, '\0');
+  while (index.Size() < n) {
+    const size_t length = std::min(chunk.size(), n - index.Size());
+    std::cin.read(chunk.data(), static_cast<std::streamsize>(length));
+    const std::string_view part(chunk.data(), static_cast<size_t>(std::cin.gcount()));
+    if (part.size() != length || !std::all_of(part.begin(), part.end(), RibbonIndex::IsLetter)) {
+      std::fprintf(stderr, "ribbon must consist of %zu latin letters\n", n);
+      std::exit(1);
+    }
+    index.Append(part);
+  }
 
-      if (w_ptr == word.length()) {
-        word_idx++;
+  std::string output;
+  std::vector<std::string> words;
+  while (q-- > 0) {
+    size_t m;
+    std::cin >> m;
+    words.resize(m);
+    for (auto& word : words) {
+      std::cin >> word;
+    }
+    output += index.Matches(words) ? "YES\n" : "NO\n";
+  }
+  std::cout << output;
+}
 
-        if (word_idx == words.size()) {
-          break;
-        }
+// Сравнение индекса с двумя указателями. Лента из строчных букв, в которую равномерно по всей длине
+// вставлены заглавные. Слова - это вставленные заглавные буквы по порядку, поэтому два указателя
+// просматривают всю ленту, а индекс прыгает только по нужным буквам
+void RunMultiBenchmark() {
+  constexpr size_t N = 10000000;
+  constexpr int32_t Queries = 5;
+
+  auto elapsed_ms = [](auto start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  std::mt19937 rng(42);
+  for (const size_t m : {1000, 10000, 100000}) {
+    std::vector<size_t> lengths(m);
+    size_t total = 0;
+    for (auto& length : lengths) {
+      length = 1 + rng() % 8;
+      total += length;
+    }
+
+    std::string s(N, ' ');
+    for (auto& ch : s) {
+      ch = static_cast<char>('a' + rng() % 26);
+    }
+    std::vector<std::string> words(m);
+    size_t planted = 0;
+    for (size_t i = 0; i < m; i++) {
+      for (size_t j = 0; j < lengths[i]; j++) {
+        const char ch = static_cast<char>('A' + rng() % 26);
+        s[planted++ * (N / total)] = ch;
+        words[i] += ch;
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    RibbonIndex index;
+    index.Append(s);
+    const double build_ms = elapsed_ms(start);
+
+    bool greedy_yes = true;
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < Queries; i++) {
+      greedy_yes &= MatchesGreedy(s, words);
+    }
+    const double greedy_ms = elapsed_ms(start) / Queries;
+
+    bool index_yes = true;
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < Queries; i++) {
+      index_yes &= index.Matches(words);
+    }
+    const double index_ms = elapsed_ms(start) / Queries;
+
+    std::printf(
+        "n=%zu m=%zu index build=%.2fms memory=%zuKB, two pointers: %.3fms/query, "
+        "index: %.3fms/query\n",
+        N,
+        m,
+        build_ms,
+        index.MemoryBytes() / 1024,
+        greedy_ms,
+        index_ms
+    );
+    if (!greedy_yes || !index_yes) {
+      std::printf("result mismatch\n");
+    }
+  }
+}
+
+constexpr size_t StreamChunkSize = size_t{1} << 22;
+
+// Ответ сопоставителя. Если слов во входе меньше m, то ответ не определен - завершаемся с ошибкой
+template <typename WordSource>
+bool MatchResult(const StreamMatcher<WordSource>& matcher, const WordSource& words, size_t m) {
+  if (words.Truncated()) {
+    std::fprintf(stderr, "word list is shorter than m = %zu\n", m);
+    std::exit(1);
+  }
+  return matcher.Done();
+}
+
+// Разбирает заголовок "n m" и возвращает смещение начала ленты
+size_t ParseHeader(std::string_view data, size_t& n, size_t& m) {
+  size_t pos = 0;
+  auto read_number = [&]() {
+    while (pos < data.size() && std::isspace(static_cast<unsigned char>(data[pos]))) {
+      pos++;
+    }
+    size_t value = 0;
+    while (pos < data.size() && data[pos] >= '0' && data[pos] <= '9') {
+      value = value * 10 + (data[pos++] - '0');
+    }
+    return value;
+  };
+  n = read_number();
+  m = read_number();
+  while (pos < data.size() && std::isspace(static_cast<unsigned char>(data[pos]))) {
+    pos++;
+  }
+  return pos;
+}
+
+// Проверка по входу, целиком лежащему в памяти. release(begin, end) вызывается для просмотренных
+// кусков ленты, чтобы их можно было выгрузить
+template <typename Release>
+bool MatchInMemory(std::string_view data, Release release) {
+  size_t n, m;
+  const size_t ribbon = ParseHeader(data, n, m);
+
+  MemoryWords words(data.substr(std::min(ribbon + n, data.size())), m);
+  StreamMatcher matcher(words);
+  for (size_t pos = 0; pos < n && !matcher.Done(); pos += StreamChunkSize) {
+    const size_t length = std::min(StreamChunkSize, n - pos);
+    matcher.Feed(data.substr(ribbon + pos, length));
+    release(ribbon + pos, ribbon + pos + length);
+  }
+  return MatchResult(matcher, words, m);
+}
+
+bool MatchMapped(const char* path) {
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    std::perror(path);
+    std::exit(1);
+  }
+  struct stat st {};
+  fstat(fd, &st);
+  const auto size = static_cast<size_t>(st.st_size);
 
-        word = words[word_idx];
-        w_ptr = 0;
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    std::perror("mmap");
+    std::exit(1);
+  }
+  madvise(mapping, size, MADV_SEQUENTIAL);
+
+  const auto* data = static_cast<const char*>(mapping);
+  const size_t page = sysconf(_SC_PAGESIZE);
+  const bool result = MatchInMemory({data, size}, [&](size_t begin, size_t end) {
+    // Освобождаем только целые страницы, лежащие внутри просмотренного куска
+    const size_t first = (begin + page - 1) / page * page;
+    const size_t last = end / page * page;
+    if (first < last) {
+      madvise(const_cast<char*>(data) + first, last - first, MADV_DONTNEED);
+    }
+  });
+
+  munmap(mapping, size);
+  return result;
+}
+
+// Проверка по файлу через pread: следующий кусок ленты читается параллельно со сканированием
+bool MatchStream(int fd) {
+  std::string header(4096, '\0');
+  const ssize_t header_size = pread(fd, header.data(), header.size(), 0);
+  header.resize(static_cast<size_t>(std::max<ssize_t>(header_size, 0)));
+  size_t n, m;
+  const size_t ribbon = ParseHeader(header, n, m);
 
-        s_ptr++;
+  FileWords words(fd, static_cast<off_t>(ribbon + n), m);
+  StreamMatcher matcher(words);
+
+  auto read_chunk = [fd, ribbon, n](std::string& buffer, size_t pos) {
+    const size_t length = std::min(StreamChunkSize, n - pos);
+    size_t done = 0;
+    while (done < length) {
+      const ssize_t read =
+          pread(fd, buffer.data() + done, length - done, static_cast<off_t>(ribbon + pos + done));
+      if (read <= 0) {
+        break;
       }
+      done += static_cast<size_t>(read);
+    }
+    return done;
+  };
+
+  std::array<std::string, 2> buffers = {std::string(StreamChunkSize, '\0'),
+                                        std::string(StreamChunkSize, '\0')};
+  size_t length = n > 0 ? read_chunk(buffers[0], 0) : 0;
+  for (size_t pos = 0, current = 0; pos < n && length > 0; pos += StreamChunkSize, current ^= 1) {
+    std::future<size_t> next;
+    if (pos + StreamChunkSize < n) {
+      next = std::async(std::launch::async, read_chunk, std::ref(buffers[current ^ 1]),
+                        pos + StreamChunkSize);
+    }
+    const bool done = matcher.Feed({buffers[current].data(), length});
+    length = next.valid() ? next.get() : 0;
+    if (done) {
+      break;
+    }
+  }
+  return MatchResult(matcher, words, m);
+}
+
+bool MatchStreamStdin() {
+  struct stat st {};
+  if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode)) {
+    return MatchStream(STDIN_FILENO);
+  }
+  const std::string input(std::istreambuf_iterator<char>(std::cin), {});
+  return MatchInMemory(input, [](size_t, size_t) {});
+}
+
+// Генерирует файл с лентой из size байт строчных букв и словами из заглавных букв, вставленных в
+// последний мегабайт ленты, и сравнивает способы чтения. Каждый способ запускается в отдельном
+// процессе, чтобы пиковая память считалась независимо
+void RunStreamBenchmark(double gigabytes) {
+  const auto n = static_cast<size_t>(gigabytes * (1 << 30));
+  constexpr size_t M = 1000;
+  const std::string path = "/tmp/ribbon_bench.txt";
+
+  {
+    std::mt19937 rng(42);
+    std::string pattern(StreamChunkSize, ' ');
+    for (auto& ch : pattern) {
+      ch = static_cast<char>('a' + rng() % 26);
+    }
+
+    std::vector<std::string> words(M);
+    std::string tail(std::min<size_t>(n, 1 << 20), ' ');
+    for (size_t i = 0; i < tail.size(); i++) {
+      tail[i] = pattern[i];
+    }
+    for (size_t i = 0; i < M; i++) {
+      const char ch = static_cast<char>('A' + rng() % 26);
+      tail[i * (tail.size() / M)] = ch;
+      words[i] = ch;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out << n << ' ' << M << '\n';
+    for (size_t pos = 0; pos + tail.size() < n; pos += pattern.size()) {
+      const size_t length = std::min(pattern.size(), n - tail.size() - pos);
+      out.write(pattern.data(), static_cast<std::streamsize>(length));
+    }
+    out << tail << '\n';
+    for (const auto& word : words) {
+      out << word << '\n';
     }
   }
 
-  if (word_idx == words.size() && w_ptr == words[words.size() - 1].length()) {
+  auto run = [&](const char* name, auto match) {
+    std::fflush(stdout);
+    const pid_t pid = fork();
+    if (pid == 0) {
+      const auto start = std::chrono::steady_clock::now();
+      const bool result = match();
+      const double seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      rusage usage{};
+      getrusage(RUSAGE_SELF, &usage);
+      std::printf(
+          "%-8s %s time=%.2fs throughput=%.2fGB/s peak_rss=%ldKB\n",
+          name,
+          result ? "YES" : "NO",
+          seconds,
+          static_cast<double>(n) / (1 << 30) / seconds,
+          usage.ru_maxrss
+      );
+      std::fflush(stdout);
+      _exit(0);
+    }
+    waitpid(pid, nullptr, 0);
+  };
+
+  std::printf("ribbon=%.2fGB words=%zu\n", static_cast<double>(n) / (1 << 30), M);
+  run("string", [&] {
+    std::ifstream in(path);
+    size_t ribbon_size, m;
+    in >> ribbon_size >> m;
+    std::string s;
+    in >> s;
+    std::vector<std::string> words(m);
+    for (auto& word : words) {
+      in >> word;
+    }
+    return MatchesGreedy(s, words);
+  });
+  run("mmap", [&] { return MatchMapped(path.c_str()); });
+  run("stream", [&] {
+    const int fd = open(path.c_str(), O_RDONLY);
+    const bool result = MatchStream(fd);
+    close(fd);
+    return result;
+  });
+
+  std::remove(path.c_str());
+}
+
+int main(int argc, char* argv[]) {
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
+  bool multi = false;
+  bool bench = false;
+  bool stream = false;
+  const char* path = nullptr;
+  const char* mmap_path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--multi") {
+      multi = true;
+    } else if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--stream") {
+      stream = true;
+    } else if (arg == "--mmap" && i + 1 < argc) {
+      mmap_path = argv[++i];
+    } else {
+      path = argv[i];
+    }
+  }
+
+  if (stream && bench) {
+    RunStreamBenchmark(path != nullptr ? std::stod(path) : 1.0);
+    return 0;
+  }
+  if (mmap_path != nullptr || stream) {
+    bool result = false;
+    if (mmap_path != nullptr) {
+      result = MatchMapped(mmap_path);
+    } else if (path != nullptr) {
+      const int fd = open(path, O_RDONLY);
+      if (fd < 0) {
+        std::perror(path);
+        return 1;
+      }
+      result = MatchStream(fd);
+      close(fd);
+    } else {
+      result = MatchStreamStdin();
+    }
+    std::cout << (result ? "YES" : "NO");
+    return 0;
+  }
+  if (multi && bench) {
+    RunMultiBenchmark();
+    return 0;
+  }
+  if (bench) {
+    RunScanBenchmark();
+    return 0;
+  }
+  if (multi) {
+    AnswerMulti();
+    return 0;
+  }
+
+  int32_t n, m;
+  std::cin >> n >> m;
+
+  std::string s;
+  std::cin >> s;
+
+  std::vector<std::string> words(m);
+  for (int i = 0; i < m; i++) {
+    std::cin >> words[i];
+  }
+
+  if (MatchesScan(s, words)) {
     std::cout << "YES";
   } else {
     std::cout << "NO";
@@ -1,8 +1,21 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "advalgo/lca.hpp"
+#include "advalgo/parse.hpp"
+#include "advalgo/tree.hpp"
+
 /*
 
 # H. Темпоральный катаклизм
@@ -61,7 +74,9 @@ dist - расстояние между вершинами, depth - глубин
 подсчитать глубину каждой вершины, а также уметь быстро находить наименьшего общего предка двух
 вершин.
 
-Для расчета глубин вершин воспользуемся BFS.
+Для расчета глубин вершин воспользуемся обходом дерева из общего модуля advalgo/tree.hpp (списки
+смежности в плоских массивах, стек без промежуточных аллокаций). `--traversal --bench` сравнивает
+этот обход с обходом по вектору векторов с std::deque на деревьях из 10^7 вершин.
 
 Для поиска предка будем использовать двоичный подъем. Для этого посчитаем массив значений up[v][k] -
 предок вершины V через 2^K шагов (для 10^5 вершин достаточно рассчитать до K = 17). Что дает
@@ -77,119 +92,608 @@ up[v][3], для найденной вершины берем p2 = up[v][1]. Э
 нужное количество раз мы найдем общего предка (максимум 17 итераций подъема). Иными словами,
 максимально поднимаемся по предкам вершин наверх, пока не найдем общего.
 
+## Параллельная обработка запросов
+После предподсчета таблицы up и depth только читаются, поэтому запросы независимы друг от друга.
+Блок из Q строк запросов во входных данных делится на THREADS непрерывных кусков по границам
+строк. Каждый поток сам разбирает свой кусок, отвечает на запросы и пишет ответы в собственный
+буфер. В конце буферы склеиваются в исходном порядке, так что вывод совпадает с последовательной
+версией. Все, что идет после Q строк запросов, не читается.
+
+Количество потоков по умолчанию равно std::thread::hardware_concurrency(), его можно задать
+аргументом `--threads K`. Аргумент `--bench` строит случайное дерево (N = 10^5, Q = 10^6) и печатает
+время обработки запросов и ускорение для числа потоков от 1 до количества ядер.
+
+## Динамическое дерево
+Если ребра дерева появляются и исчезают во время работы, пересчитывать up и depth после каждого
+изменения слишком дорого: O(N * log2(N)) на изменение. Для этого случая есть режим `--dynamic`,
+основанный на Link-Cut дереве (Sleator, Tarjan). Каждый предпочтительный путь хранится в
+splay-дереве с ключом по глубине, в вершине поддерживается размер поддерева. Операции Link(u, v),
+Cut(u, v) и Distance(u, v) выполняются за амортизированное O(log N): Distance делает u корнем,
+открывает путь до v и возвращает количество вершин на нем минус один.
+
+Формат ввода режима `--dynamic`: в первой строке числа N и M, далее M ребер исходного леса, затем
+число Q и Q операций:
+- l u v — добавить ребро (u и v лежат в разных деревьях);
+- c u v — удалить существующее ребро;
+- q u v T — вывести "Yes", если u и v связаны и расстояние между ними не превосходит T, иначе "No".
+
+`--dynamic --bench` сравнивает Link-Cut дерево с пересчетом таблицы up после каждого изменения.
+
+## Агрегаты на пути
+Если у ребер есть веса, та же таблица up отвечает и на вопросы о весах пути. Рядом с up[v][k]
+хранятся максимум и минимум весов 2^k ребер над вершиной V, и при подъеме к lca они собираются по
+пройденным прыжкам: максимум, минимум и lca пути - за один проход, O(log N). Сумма и xor весов от
+корня считаются один раз обходом: для xor общая часть путей от корня сокращается, поэтому xor на
+пути - это xor[u] ^ xor[v] за O(1), а сумма - sum[u] + sum[v] - 2 sum[lca]. Таблица строится с
+агрегатами только в режиме `--aggregate`, обычные запросы на расстояние ее не ждут.
+
+Формат ввода режима `--aggregate`: число N, далее N-1 ребер u v w с весами 0 ≤ w < 2^31, затем
+число Q и Q операций:
+- m u v — вывести максимальный вес ребра на пути (-1, если u = v);
+- n u v — вывести минимальный вес ребра на пути (-1, если u = v);
+- s u v — вывести сумму весов на пути;
+- x u v — вывести xor весов на пути;
+- q u v T — вывести "Yes", если расстояние между u и v не превосходит T, иначе "No".
+
+`--aggregate --bench` отвечает на 10^6 случайных операций всех видов на случайном дереве и на
+глубоком дереве (N = 10^5) и сверяет часть ответов с проходом по пути через родителей.
+
 ## Асимптотика решения
-Время: O(N * log2(N_max) + Q * log2(N_max))
-Память: O(N * log2(N_max))
+Время: O(N * log2(N_max) + Q * log2(N_max) / THREADS)
+Память: O(N * log2(N_max) + Q)
 
 */
 
-int main() {
-  std::ios::sync_with_stdio(false);
-  std::cin.tie(nullptr);
-
-  int32_t N;
-  std::cin >> N;
+// Разбирает запросы из куска [begin, end) и дописывает ответы в out
+void AnswerQueries(const LcaTable& table, const char* begin, const char* end, std::string& out) {
+  out.reserve(out.size() + (end - begin) / 2);
 
-  std::vector<std::vector<int32_t>> g;
-  g.resize(N);
+  const char* ptr = begin;
+  while (SkipToNumber(ptr, end)) {
+    const int32_t u = ReadNumber(ptr, end);
+    const int32_t v = ReadNumber(ptr, end);
+    const int32_t T = ReadNumber(ptr, end);
 
-  for (int32_t i = 0; i < N - 1; i++) {
-    int32_t u, v;
-    std::cin >> u >> v;
-    g[u].push_back(v);
-    g[v].push_back(u);
+    if (table.Distance(u, v) <= T) {
+      out += "Yes\n";
+    } else {
+      out += "No\n";
+    }
   }
+}
 
-  // --- LCA подготовка ---
-  const int32_t LOG = 17;  // так как 2^17 > 1e5
-  std::vector<std::vector<int32_t>> up(N, std::vector<int32_t>(LOG));
-  std::vector<int32_t> depth(N);
+// Делит блок запросов на threads кусков по границам строк и обрабатывает их параллельно
+std::string AnswerAllQueries(
+    const LcaTable& table,
+    const char* begin,
+    const char* end,
+    uint32_t threads
+) {
+  threads = std::max<uint32_t>(threads, 1);
+
+  std::vector<const char*> bounds(threads + 1, end);
+  bounds[0] = begin;
+  const size_t length = end - begin;
+  for (uint32_t i = 1; i < threads; i++) {
+    const char* pos = std::max(begin + length * i / threads, bounds[i - 1]);
+    const void* newline = std::memchr(pos, '\n', end - pos);
+    bounds[i] = newline != nullptr ? static_cast<const char*>(newline) + 1 : end;
+  }
 
-  // DFS для depth[] и up[][0]
-  std::vector<int32_t> stack;
-  stack.reserve(N);
-  stack.push_back(0);
+  std::vector<std::string> outputs(threads);
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (uint32_t i = 1; i < threads; i++) {
+    workers.emplace_back(AnswerQueries, std::cref(table), bounds[i], bounds[i + 1],
+                         std::ref(outputs[i]));
+  }
+  AnswerQueries(table, bounds[0], bounds[1], outputs[0]);
+  for (auto& worker : workers) {
+    worker.join();
+  }
 
-  up[0][0] = 0;
-  depth[0] = 0;
+  size_t total = 0;
+  for (const auto& output : outputs) {
+    total += output.size();
+  }
+  std::string result;
+  result.reserve(total);
+  for (const auto& output : outputs) {
+    result += output;
+  }
+  return result;
+}
 
-  std::vector<int32_t> parent(N, -1);
-  parent[0] = 0;
+// Замер ускорения обработки запросов на случайном дереве при разном числе потоков
+void RunQueriesBenchmark(uint32_t max_threads) {
+  constexpr int32_t N = 100000;
+  constexpr int32_t Q = 1000000;
 
-  while (!stack.empty()) {
-    int32_t v = stack.back();
-    stack.pop_back();
+  std::mt19937 rng(42);
+  std::vector<Edge> edges;
+  for (int32_t v = 1; v < N; v++) {
+    edges.push_back({static_cast<int32_t>(rng() % v), v});
+  }
+  const LcaTable table(Tree(N, edges));
 
-    for (int32_t to : g[v]) {
-      if (to == parent[v])
-        continue;
-      parent[to] = v;
-      depth[to] = depth[v] + 1;
-      up[to][0] = v;
-      stack.push_back(to);
+  std::string queries;
+  queries.reserve(static_cast<size_t>(Q) * 20);
+  for (int32_t i = 0; i < Q; i++) {
+    queries += std::to_string(rng() % N) + ' ' + std::to_string(rng() % N) + ' ' +
+               std::to_string(rng() % N) + '\n';
+  }
+  const char* begin = queries.data();
+  const char* end = begin + queries.size();
+
+  const std::string expected = AnswerAllQueries(table, begin, end, 1);
+  double base_ms = 0;
+  for (uint32_t threads = 1; threads <= max_threads; threads++) {
+    double best_ms = 1e18;
+    for (int32_t run = 0; run < 3; run++) {
+      const auto start = std::chrono::steady_clock::now();
+      const std::string result = AnswerAllQueries(table, begin, end, threads);
+      const auto finish = std::chrono::steady_clock::now();
+      if (result != expected) {
+        std::printf("threads=%u: result mismatch\n", threads);
+        return;
+      }
+      const double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+      best_ms = std::min(best_ms, ms);
+    }
+    if (threads == 1) {
+      base_ms = best_ms;
     }
+    std::printf("threads=%u time=%.2fms speedup=%.2f\n", threads, best_ms, base_ms / best_ms);
   }
+}
 
-  // Заполняем таблицу подъёмов up[v][k]
-  for (int32_t k = 1; k < LOG; k++) {
-    for (int32_t v = 0; v < N; v++) {
-      up[v][k] = up[up[v][k - 1]][k - 1];
-    }
+// Ответы на операции динамического режима: l u v, c u v, q u v T
+std::string AnswerDynamic(const char*& ptr, const char* end) {
+  const int32_t N = ReadNumber(ptr, end);
+  const int32_t M = ReadNumber(ptr, end);
+
+  LinkCutTree tree(N);
+  for (int32_t i = 0; i < M; i++) {
+    const int32_t u = ReadNumber(ptr, end);
+    const int32_t v = ReadNumber(ptr, end);
+    tree.Link(u, v);
   }
 
-  // Функция подъёма
-  auto lift = [&](int32_t v, int32_t h) {
-    for (int32_t k = 0; k < LOG; k++) {
-      if (h & (1 << k)) {
-        v = up[v][k];
+  int32_t Q = ReadNumber(ptr, end);
+  std::string result;
+  result.reserve(static_cast<size_t>(Q) * 4);
+
+  while (Q-- > 0) {
+    const char op = ReadOp(ptr, end);
+    const int32_t u = ReadNumber(ptr, end);
+    const int32_t v = ReadNumber(ptr, end);
+
+    if (op == 'l') {
+      tree.Link(u, v);
+    } else if (op == 'c') {
+      tree.Cut(u, v);
+    } else {
+      const int32_t T = ReadNumber(ptr, end);
+      const int32_t dist = tree.Distance(u, v);
+      if (dist != -1 && dist <= T) {
+        result += "Yes\n";
+      } else {
+        result += "No\n";
       }
     }
-    return v;
+  }
+
+  return result;
+}
+
+// Сравнение Link-Cut дерева с пересчетом LcaTable после каждого изменения дерева. Изменение -
+// перевешивание случайной вершины (cut + link), после каждого изменения - QueriesPerChange запросов
+void RunDynamicBenchmark() {
+  constexpr int32_t N = 100000;
+  constexpr int32_t Changes = 200;
+  constexpr int32_t QueriesPerChange = 5;
+
+  struct Op {
+    int32_t cut_u, cut_v, link_u, link_v;
+    std::array<std::array<int32_t, 2>, QueriesPerChange> queries;
   };
 
-  // LCA
-  auto lca = [&](int32_t a, int32_t b) {
-    if (depth[a] < depth[b]) {
-      int32_t tmp = a;
-      a = b;
-      b = tmp;
+  std::mt19937 rng(42);
+  LinkCutTree generator(N);
+  std::vector<int32_t> parent(N, -1);
+  for (int32_t v = 1; v < N; v++) {
+    parent[v] = static_cast<int32_t>(rng() % v);
+    generator.Link(v, parent[v]);
+  }
+  const std::vector<int32_t> initial_parent = parent;
+
+  // Генерируем изменения заранее: отрезаем поддерево v и подвешиваем его к вершине вне поддерева
+  std::vector<Op> ops(Changes);
+  for (auto& op : ops) {
+    int32_t v = 0;
+    while (parent[v] == -1) {
+      v = static_cast<int32_t>(rng() % N);
+    }
+    generator.Cut(v, parent[v]);
+    int32_t w = static_cast<int32_t>(rng() % N);
+    while (generator.Distance(v, w) != -1) {
+      w = static_cast<int32_t>(rng() % N);
     }
+    generator.Link(v, w);
+    op = {v, parent[v], v, w, {}};
+    parent[v] = w;
+    for (auto& query : op.queries) {
+      query = {static_cast<int32_t>(rng() % N), static_cast<int32_t>(rng() % N)};
+    }
+  }
 
-    a = lift(a, depth[a] - depth[b]);
-    if (a == b)
-      return a;
+  int64_t checksum_lct = 0;
+  auto start = std::chrono::steady_clock::now();
+  LinkCutTree tree(N);
+  for (int32_t v = 1; v < N; v++) {
+    tree.Link(v, initial_parent[v]);
+  }
+  for (const auto& op : ops) {
+    tree.Cut(op.cut_u, op.cut_v);
+    tree.Link(op.link_u, op.link_v);
+    for (const auto& [u, v] : op.queries) {
+      checksum_lct += tree.Distance(u, v);
+    }
+  }
+  auto finish = std::chrono::steady_clock::now();
+  const double lct_ms = std::chrono::duration<double, std::milli>(finish - start).count();
 
-    for (int32_t k = LOG - 1; k >= 0; k--) {
-      if (up[a][k] != up[b][k]) {
-        a = up[a][k];
-        b = up[b][k];
-      }
+  // Ребро вершины v к ее родителю хранится в edges[v - 1], перевешивание заменяет его
+  std::vector<Edge> edges;
+  for (int32_t v = 1; v < N; v++) {
+    edges.push_back({v, initial_parent[v]});
+  }
+
+  int64_t checksum_rebuild = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto& op : ops) {
+    edges[op.link_u - 1] = {op.link_u, op.link_v};
+
+    const LcaTable table(Tree(N, edges));
+    for (const auto& [u, v] : op.queries) {
+      checksum_rebuild += table.Distance(u, v);
     }
-    return up[a][0];
+  }
+  finish = std::chrono::steady_clock::now();
+  const double rebuild_ms = std::chrono::duration<double, std::milli>(finish - start).count();
+
+  std::printf("N=%d changes=%d queries/change=%d\n", N, Changes, QueriesPerChange);
+  std::printf("link-cut: %.2fms (%.2fus/change)\n", lct_ms, lct_ms * 1000 / Changes);
+  std::printf("rebuild:  %.2fms (%.2fus/change)\n", rebuild_ms, rebuild_ms * 1000 / Changes);
+  if (checksum_lct != checksum_rebuild) {
+    std::printf("result mismatch\n");
+  }
+}
+
+// Сравнение обхода по вектору векторов с std::deque и std::vector<bool> и обходов из tree.hpp на
+// случайном дереве и дереве-пути из N вершин
+void RunTraversalBenchmark() {
+  constexpr int32_t N = 10000000;
+
+  auto elapsed_ms = [](auto start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
   };
 
-  // --- Обработка запросов ---
-  int32_t Q;
-  std::cin >> Q;
+  std::mt19937 rng(42);
+  for (const bool path : {false, true}) {
+    std::vector<Edge> edges;
+    edges.reserve(N - 1);
+    for (int32_t v = 1; v < N; v++) {
+      const auto u = path ? v - 1 : static_cast<int32_t>(rng() % v);
+      edges.push_back({u, v, static_cast<int32_t>(rng())});
+    }
+    std::printf("%s tree, N=%d\n", path ? "path" : "random", N);
+
+    int64_t legacy_checksum = 0;
+    {
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::vector<std::pair<int32_t, int32_t>>> adj(N);
+      for (const Edge& e : edges) {
+        adj[e.u].push_back({e.v, e.w});
+        adj[e.v].push_back({e.u, e.w});
+      }
+      const double build_ms = elapsed_ms(start);
+
+      start = std::chrono::steady_clock::now();
+      std::vector<int32_t> val(N, 0);
+      std::vector<bool> used(N, false);
+      std::deque<int32_t> dq;
+      dq.push_back(0);
+      used[0] = true;
+      while (!dq.empty()) {
+        const int32_t u = dq.front();
+        dq.pop_front();
+        for (const auto& [v, w] : adj[u]) {
+          if (!used[v]) {
+            used[v] = true;
+            val[v] = val[u] ^ w;
+            dq.push_back(v);
+          }
+        }
+      }
+      for (int32_t x : val) {
+        legacy_checksum += x;
+      }
+      std::printf("  vector<vector> + deque bfs: build=%.2fms bfs=%.2fms\n", build_ms,
+                  elapsed_ms(start));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const Tree tree(N, edges);
+    const double build_ms = elapsed_ms(start);
 
+    start = std::chrono::steady_clock::now();
+    const Traversal bfs = Bfs(tree, 0);
+    const double bfs_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    const Traversal dfs = Dfs(tree, 0);
+    const double dfs_ms = elapsed_ms(start);
+
+    std::printf("  csr tree: build=%.2fms bfs=%.2fms dfs=%.2fms\n", build_ms, bfs_ms, dfs_ms);
+
+    int64_t bfs_checksum = 0;
+    int64_t dfs_checksum = 0;
+    for (int32_t v = 0; v < N; v++) {
+      bfs_checksum += bfs.xor_prefix[v];
+      dfs_checksum += dfs.xor_prefix[v];
+    }
+    if (bfs_checksum != legacy_checksum || dfs_checksum != legacy_checksum) {
+      std::printf("  result mismatch\n");
+    }
+  }
+}
+
+// Ответы на операции режима с весами: m u v, n u v, s u v, x u v, q u v T
+std::string AnswerAggregates(const char*& ptr, const char* end) {
+  const int32_t N = ReadNumber(ptr, end);
+
+  std::vector<Edge> edges(N > 0 ? N - 1 : 0);
+  for (auto& e : edges) {
+    e.u = ReadNumber(ptr, end);
+    e.v = ReadNumber(ptr, end);
+    e.w = ReadNumber(ptr, end);
+  }
+  const LcaTable table(Tree(N, edges), true);
+
+  int32_t Q = ReadNumber(ptr, end);
   std::string result;
+  result.reserve(static_cast<size_t>(Q) * 8);
+
+  while (Q-- > 0) {
+    const char op = ReadOp(ptr, end);
+    const int32_t u = ReadNumber(ptr, end);
+    const int32_t v = ReadNumber(ptr, end);
+
+    if (op == 'q') {
+      const int32_t T = ReadNumber(ptr, end);
+      result += table.Distance(u, v) <= T ? "Yes\n" : "No\n";
+    } else if (op == 'x') {
+      result += std::to_string(table.PathXor(u, v)) + '\n';
+    } else {
+      const PathAggregate path = table.Aggregate(u, v);
+      const int64_t value = op == 'm' ? path.max_weight : op == 'n' ? path.min_weight : path.sum;
+      result += std::to_string(value) + '\n';
+    }
+  }
 
-  while (Q--) {
+  return result;
+}
+
+// Агрегаты пути проходом от вершин к lca через родителей: эталон для RunAggregateBenchmark
+PathAggregate WalkPath(
+    const Traversal& t,
+    const std::vector<int32_t>& weight,
+    int32_t a,
+    int32_t b
+) {
+  PathAggregate path;
+  auto step = [&](int32_t& v) {
+    path.max_weight = path.edges == 0 ? weight[v] : std::max(path.max_weight, weight[v]);
+    path.min_weight = path.edges == 0 ? weight[v] : std::min(path.min_weight, weight[v]);
+    path.sum += weight[v];
+    path.xor_sum ^= weight[v];
+    path.edges++;
+    v = t.parent[v];
+  };
+  while (t.depth[a] > t.depth[b]) {
+    step(a);
+  }
+  while (t.depth[b] > t.depth[a]) {
+    step(b);
+  }
+  while (a != b) {
+    step(a);
+    step(b);
+  }
+  return path;
+}
+
+// 10^6 случайных операций режима --aggregate на случайном и глубоком дереве. Первые Reference
+// операций сверяются с проходом по пути через родителей
+void RunAggregateBenchmark() {
+  constexpr int32_t N = 100000;
+  constexpr int32_t Q = 1000000;
+  constexpr int32_t Reference = 2000;
+  constexpr std::array<char, 5> Ops = {'m', 'n', 's', 'x', 'q'};
+
+  struct Op {
+    char op;
     int32_t u, v;
-    int32_t T;
-    std::cin >> u >> v >> T;
+  };
 
-    int32_t c = lca(u, v);
-    int32_t dist = depth[u] + depth[v] - 2 * depth[c];
+  auto elapsed_ms = [](auto start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
 
-    if (dist <= T) {
-      result += "Yes\n";
-    } else {
-      result += "No\n";
+  std::mt19937 rng(42);
+  for (const bool deep : {false, true}) {
+    // В глубоком дереве родитель - одна из четырех предыдущих вершин, глубина порядка N / 2.5
+    std::vector<Edge> edges;
+    edges.reserve(N - 1);
+    for (int32_t v = 1; v < N; v++) {
+      const auto u = deep ? std::max<int32_t>(0, v - 1 - static_cast<int32_t>(rng() % 4))
+                          : static_cast<int32_t>(rng() % v);
+      edges.push_back({u, v, static_cast<int32_t>(rng() % 1000000000)});
+    }
+    std::vector<Op> ops(Q);
+    for (auto& op : ops) {
+      op = {Ops[rng() % Ops.size()], static_cast<int32_t>(rng() % N),
+            static_cast<int32_t>(rng() % N)};
+    }
+    const Tree tree(N, edges);
+    std::printf("%s tree, N=%d Q=%d\n", deep ? "deep" : "random", N, Q);
+
+    auto start = std::chrono::steady_clock::now();
+    const LcaTable plain(tree);
+    const double plain_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    const LcaTable table(tree, true);
+    std::printf("  build: lca=%.2fms lca+aggregates=%.2fms\n", plain_ms, elapsed_ms(start));
+
+    // Ответ на операцию одним числом, для q - расстоянием
+    auto answer = [&](const Op& op) -> int64_t {
+      switch (op.op) {
+        case 'm':
+          return table.Aggregate(op.u, op.v).max_weight;
+        case 'n':
+          return table.Aggregate(op.u, op.v).min_weight;
+        case 's':
+          return table.Aggregate(op.u, op.v).sum;
+        case 'x':
+          return table.PathXor(op.u, op.v);
+        default:
+          return table.Distance(op.u, op.v);
+      }
+    };
+
+    int64_t checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const Op& op : ops) {
+      checksum += answer(op);
+    }
+    const double mixed_ms = elapsed_ms(start);
+    std::printf("  mixed: %.2fms (%.1fns/op) checksum=%lld\n", mixed_ms, mixed_ms * 1e6 / Q,
+                static_cast<long long>(checksum));
+
+    // xor через подъем к lca и через префиксы
+    int64_t lifted = 0;
+    start = std::chrono::steady_clock::now();
+    for (const Op& op : ops) {
+      lifted += table.Aggregate(op.u, op.v).xor_sum;
+    }
+    const double lifted_ms = elapsed_ms(start);
+    int64_t prefix = 0;
+    start = std::chrono::steady_clock::now();
+    for (const Op& op : ops) {
+      prefix += table.PathXor(op.u, op.v);
     }
+    const double prefix_ms = elapsed_ms(start);
+    std::printf("  xor: aggregate=%.1fns/op prefix=%.1fns/op\n", lifted_ms * 1e6 / Q,
+                prefix_ms * 1e6 / Q);
+
+    const Traversal dfs = Dfs(tree, 0);
+    std::vector<int32_t> weight(N, 0);
+    for (int32_t v = 1; v < N; v++) {
+      weight[v] = dfs.xor_prefix[v] ^ dfs.xor_prefix[dfs.parent[v]];
+    }
+    bool mismatch = lifted != prefix;
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < Reference; i++) {
+      const PathAggregate path = WalkPath(dfs, weight, ops[i].u, ops[i].v);
+      const int64_t expected = ops[i].op == 'm'   ? path.max_weight
+                               : ops[i].op == 'n' ? path.min_weight
+                               : ops[i].op == 's' ? path.sum
+                               : ops[i].op == 'x' ? path.xor_sum
+                                                  : path.edges;
+      mismatch = mismatch || answer(ops[i]) != expected;
+    }
+    std::printf("  walk:  %.1fns/op on first %d ops\n", elapsed_ms(start) * 1e6 / Reference,
+                Reference);
+    if (mismatch) {
+      std::printf("  result mismatch\n");
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t threads = std::thread::hardware_concurrency();
+  bool bench = false;
+  bool dynamic = false;
+  bool traversal = false;
+  bool aggregate = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoul(argv[++i]);
+    } else if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--dynamic") {
+      dynamic = true;
+    } else if (arg == "--traversal") {
+      traversal = true;
+    } else if (arg == "--aggregate") {
+      aggregate = true;
+    }
+  }
+  threads = std::max<uint32_t>(threads, 1);
+
+  if (bench && traversal) {
+    RunTraversalBenchmark();
+    return 0;
+  }
+  if (bench && aggregate) {
+    RunAggregateBenchmark();
+    return 0;
+  }
+  if (bench && dynamic) {
+    RunDynamicBenchmark();
+    return 0;
   }
+  if (bench) {
+    RunQueriesBenchmark(threads);
+    return 0;
+  }
+
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
+  // Считываем вход целиком, чтобы потоки могли разбирать запросы прямо из буфера
+  const std::string input(std::istreambuf_iterator<char>(std::cin), {});
+  const char* ptr = input.data();
+  const char* end = ptr + input.size();
+
+  if (dynamic) {
+    std::cout << AnswerDynamic(ptr, end);
+    return 0;
+  }
+  if (aggregate) {
+    std::cout << AnswerAggregates(ptr, end);
+    return 0;
+  }
+
+  const int32_t N = ReadNumber(ptr, end);
+
+  std::vector<Edge> edges(N > 0 ? N - 1 : 0);
+  for (auto& e : edges) {
+    e.u = ReadNumber(ptr, end);
+    e.v = ReadNumber(ptr, end);
+  }
+
+  const LcaTable table(Tree(N, edges));
+
+  // --- Обработка запросов ---
+  const int32_t Q = ReadNumber(ptr, end);
+  SkipToNumber(ptr, end);
 
-  std::cout << result;
+  std::cout << AnswerAllQueries(table, ptr, SkipLines(ptr, end, Q), threads);
 
   return 0;
 }
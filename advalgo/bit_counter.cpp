@@ -0,0 +1,29 @@
+#include "advalgo/bit_counter.hpp"
+
+void BitCounter::Add(uint32_t S) {
+  bits_[S]++;
+
+  while (bits_[S] == 2) {
+    bits_[S] = 0;
+    ones_--;
+
+    S++;
+    bits_[S]++;
+  }
+
+  ones_++;
+}
+
+void BitCounter::Subtract(uint32_t S) {
+  bits_[S]--;
+
+  while (bits_[S] == -1) {
+    bits_[S] = 1;
+    ones_++;
+
+    S++;
+    bits_[S]--;
+  }
+
+  ones_--;
+}
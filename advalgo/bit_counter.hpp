@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*
+
+# Счетчик единиц
+
+Движок задачи B (подробное описание - в B.cpp): число x хранится по байту на двоичный разряд,
+прибавление и вычитание 2^S честно распространяют перенос и заем, количество единиц поддерживается
+при каждом изменении разряда.
+
+*/
+
+class BitCounter {
+  std::vector<int8_t> bits_;
+  uint32_t ones_ = 0;
+
+public:
+  // size - количество разрядов, с запасом на переносы
+  explicit BitCounter(uint32_t size = 200000) : bits_(size, 0) {
+  }
+
+  // x += 2^S
+  void Add(uint32_t S);
+
+  // x -= 2^S, x должен остаться неотрицательным
+  void Subtract(uint32_t S);
+
+  // Количество единиц в двоичной записи x
+  uint32_t Ones() const {
+    return ones_;
+  }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+/*
+
+# Битовые маски
+
+Общие помощники для движков на битовых масках (SegmentedArray, ScoreBuckets): сборка функций с
+popcount в варианте с инструкцией popcnt и поиск единичного бита по номеру.
+
+*/
+
+// popcnt не входит в базовый x86-64, и без него std::popcount - вызов функции из libgcc. Функции с
+// popcount собираются в двух вариантах, нужный выбирается при загрузке программы
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define POPCNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#else
+#define POPCNT_CLONES
+#endif
+
+// Номер бита с номером rank (с 0) среди единичных битов bits. Половинами слова спускаемся до
+// байта с нужным битом, в нем снимаем младшие единицы. Вызывать из функций с POPCNT_CLONES
+inline uint32_t SelectBit(uint64_t bits, uint32_t rank) {
+  uint32_t pos = 0;
+  for (uint32_t width = 32; width >= 8; width /= 2) {
+    const uint64_t low = bits & ((uint64_t{1} << width) - 1);
+    const auto count = static_cast<uint32_t>(std::popcount(low));
+    if (rank >= count) {
+      rank -= count;
+      bits >>= width;
+      pos += width;
+    } else {
+      bits = low;
+    }
+  }
+  for (; rank > 0; rank--) {
+    bits &= bits - 1;
+  }
+  return pos + std::countr_zero(bits);
+}
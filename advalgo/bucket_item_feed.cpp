@@ -0,0 +1,172 @@
+#include "advalgo/bucket_item_feed.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+namespace youndex::express {
+
+std::vector<std::uint64_t> BucketItemFeed::GetAtPosition(
+    const std::size_t position,
+    const std::size_t limit
+) const {
+  assert(1 <= limit && limit <= 16);
+  auto [bucket, offset] = FenwickFind(position);
+
+  // Кусок с позицией - проходом по размерам кусков корзины
+  std::size_t chunk = 0;
+  for (const auto& chunks = buckets_[bucket].chunks; offset >= chunks[chunk].size(); chunk++) {
+    offset -= chunks[chunk].size();
+  }
+  return Page({bucket, chunk, offset}, limit);
+}
+
+std::vector<std::uint64_t> BucketItemFeed::GetAtItemWithId(
+    const std::uint64_t uid,
+    const std::size_t limit
+) const {
+  assert(1 <= limit && limit <= 16);
+  const std::uint16_t score = scores_.at(uid);
+  const Bucket& bucket = buckets_[score];
+  const std::size_t chunk = ChunkOf(bucket, uid);
+  const Chunk& ids = bucket.chunks[chunk];
+  const auto index = static_cast<std::size_t>(std::lower_bound(ids.begin(), ids.end(), uid) -
+                                              ids.begin());
+  return Page({score, chunk, index}, limit);
+}
+
+void BucketItemFeed::Add(const Item item) {
+  assert(scores_.count(item.id) == 0);
+  scores_[item.id] = item.score;
+
+  Bucket& bucket = buckets_[item.score];
+  if (bucket.chunks.empty()) {
+    bucket.chunks.push_back({item.id});
+  } else {
+    const std::size_t chunk = ChunkOf(bucket, item.id);
+    Chunk& ids = bucket.chunks[chunk];
+    ids.insert(std::lower_bound(ids.begin(), ids.end(), item.id), item.id);
+
+    // Переполненный кусок делится пополам
+    if (ids.size() > chunk_size_) {
+      Chunk upper(ids.begin() + static_cast<std::ptrdiff_t>(ids.size() / 2), ids.end());
+      ids.resize(ids.size() / 2);
+      bucket.chunks.insert(bucket.chunks.begin() + static_cast<std::ptrdiff_t>(chunk) + 1,
+                           std::move(upper));
+    }
+  }
+  FenwickAdd(item.score, 1);
+  MarkBucket(item.score);
+}
+
+void BucketItemFeed::Remove(const std::uint64_t uid) {
+  const auto it = scores_.find(uid);
+  assert(it != scores_.end());
+  const std::uint16_t score = it->second;
+  scores_.erase(it);
+
+  Bucket& bucket = buckets_[score];
+  const std::size_t chunk = ChunkOf(bucket, uid);
+  Chunk& ids = bucket.chunks[chunk];
+  ids.erase(std::lower_bound(ids.begin(), ids.end(), uid));
+  if (ids.empty()) {
+    bucket.chunks.erase(bucket.chunks.begin() + static_cast<std::ptrdiff_t>(chunk));
+  }
+  FenwickAdd(score, -1);
+  MarkBucket(score);
+}
+
+void BucketItemFeed::FenwickAdd(const std::uint32_t bucket, const std::int32_t delta) {
+  for (std::uint32_t i = bucket + 1; i <= Buckets; i += i & (~i + 1)) {
+    fenwick_[i] += static_cast<std::uint32_t>(delta);
+  }
+}
+
+std::pair<std::uint32_t, std::size_t> BucketItemFeed::FenwickFind(std::size_t position) const {
+  // Спуск по степеням двойки: pos - наибольший префикс корзин с суммой не больше position
+  std::uint32_t pos = 0;
+  for (std::uint32_t step = Buckets; step > 0; step >>= 1) {
+    if (pos + step <= Buckets && fenwick_[pos + step] <= position) {
+      pos += step;
+      position -= fenwick_[pos];
+    }
+  }
+  return {pos, position};
+}
+
+void BucketItemFeed::MarkBucket(const std::uint32_t bucket) {
+  const std::uint32_t word = bucket >> 6;
+  if (buckets_[bucket].chunks.empty()) {
+    nonempty_[word] &= ~(std::uint64_t{1} << (bucket & 63));
+  } else {
+    nonempty_[word] |= std::uint64_t{1} << (bucket & 63);
+  }
+  if (nonempty_[word] == 0) {
+    nonempty_summary_[word >> 6] &= ~(std::uint64_t{1} << (word & 63));
+  } else {
+    nonempty_summary_[word >> 6] |= std::uint64_t{1} << (word & 63);
+  }
+}
+
+std::uint32_t BucketItemFeed::NextNonempty(const std::uint32_t bucket) const {
+  if (bucket >= Buckets) {
+    return Buckets;
+  }
+  std::uint32_t word = bucket >> 6;
+  const std::uint64_t bits = nonempty_[word] & (~std::uint64_t{0} << (bucket & 63));
+  if (bits != 0) {
+    return (word << 6) + std::countr_zero(bits);
+  }
+
+  // Следующее непустое слово - по сводке
+  for (std::uint32_t summary = (word + 1) >> 6; summary < nonempty_summary_.size(); summary++) {
+    std::uint64_t words = nonempty_summary_[summary];
+    if (summary == (word + 1) >> 6) {
+      words &= ~std::uint64_t{0} << ((word + 1) & 63);
+    }
+    if (words != 0) {
+      word = (summary << 6) + std::countr_zero(words);
+      return (word << 6) + std::countr_zero(nonempty_[word]);
+    }
+  }
+  return Buckets;
+}
+
+std::size_t BucketItemFeed::ChunkOf(const Bucket& bucket, const std::uint64_t uid) {
+  // Первый кусок, последний id которого не меньше uid, иначе последний кусок
+  const auto it = std::lower_bound(
+      bucket.chunks.begin(), bucket.chunks.end(), uid,
+      [](const Chunk& chunk, const std::uint64_t id) { return chunk.back() < id; }
+  );
+  const auto chunk = static_cast<std::size_t>(it - bucket.chunks.begin());
+  return std::min(chunk, bucket.chunks.size() - 1);
+}
+
+std::vector<std::uint64_t> BucketItemFeed::Page(Cursor cursor, const std::size_t limit) const {
+  std::vector<std::uint64_t> result;
+  result.reserve(limit);
+  while (result.size() < limit) {
+    const auto& chunks = buckets_[cursor.bucket].chunks;
+    const Chunk& ids = chunks[cursor.chunk];
+    const std::size_t take = std::min(limit - result.size(), ids.size() - cursor.index);
+    result.insert(result.end(), ids.begin() + static_cast<std::ptrdiff_t>(cursor.index),
+                  ids.begin() + static_cast<std::ptrdiff_t>(cursor.index + take));
+    if (result.size() == limit) {
+      break;
+    }
+
+    cursor.index = 0;
+    if (++cursor.chunk < chunks.size()) {
+      continue;
+    }
+    cursor.chunk = 0;
+    cursor.bucket = NextNonempty(cursor.bucket + 1);
+    if (cursor.bucket == Buckets) {
+      break;
+    }
+  }
+  return result;
+}
+
+}  // namespace youndex::express
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "advalgo/item_feed.hpp"
+
+/*
+
+# Лента товаров по корзинам рейтингов
+
+Вариант движка задачи C без дерева: рейтинг занимает 16 бит, поэтому товары раскладываются по 65536
+корзинам, в корзине id хранятся по возрастанию. Порядок ленты - корзины по возрастанию рейтинга, в
+корзине - по id, то есть тот же порядок (score, id), что и в ItemFeed.
+
+- Дерево Фенвика по размерам корзин находит корзину с позицией position за 16 шагов.
+- Двухуровневая битовая маска непустых корзин (1024 слова и 16 слов сводки) дает следующую
+  непустую корзину через tzcnt, поэтому страница не перебирает пустые корзины по одной.
+- Update - удаление id из одной корзины и вставка в другую, без балансировки.
+
+Корзина - список отсортированных кусков не длиннее chunk_size id. В маленькой корзине кусок один, а
+если все товары попали в одну корзину, вставка и удаление сдвигают только один кусок, а не всю
+корзину; позиция внутри корзины ищется проходом по размерам кусков.
+
+*/
+
+namespace youndex::express {
+
+class BucketItemFeed final {
+public:
+  explicit BucketItemFeed(std::size_t chunk_size = 256)
+      : chunk_size_(chunk_size), buckets_(Buckets), fenwick_(Buckets + 1, 0) {
+  }
+
+  [[nodiscard]] std::vector<std::uint64_t> GetAtPosition(std::size_t position, std::size_t limit)
+      const;
+
+  [[nodiscard]] std::vector<std::uint64_t> GetAtItemWithId(std::uint64_t uid, std::size_t limit)
+      const;
+
+  void Add(Item item);
+
+  void Update(Item item) {
+    Remove(item.id);
+    Add(item);
+  }
+
+  void Remove(std::uint64_t uid);
+
+private:
+  static constexpr std::uint32_t Buckets = 65536;
+  static constexpr std::uint32_t Levels = 16;  // Buckets = 2^Levels
+
+  using Chunk = std::vector<std::uint64_t>;
+
+  // Куски корзины по возрастанию id, все непустые
+  struct Bucket {
+    std::vector<Chunk> chunks;
+  };
+
+  // Позиция в ленте: корзина, кусок в ней и номер id в куске
+  struct Cursor {
+    std::uint32_t bucket;
+    std::size_t chunk;
+    std::size_t index;
+  };
+
+  std::size_t chunk_size_;
+  std::vector<Bucket> buckets_;
+  std::vector<std::uint32_t> fenwick_;  // с 1, по размерам корзин
+  std::array<std::uint64_t, Buckets / 64> nonempty_{};
+  std::array<std::uint64_t, Buckets / 64 / 64> nonempty_summary_{};
+  std::unordered_map<std::uint64_t, std::uint16_t> scores_;
+
+  void FenwickAdd(std::uint32_t bucket, std::int32_t delta);
+
+  // Корзина с позицией position и номер позиции в ней
+  std::pair<std::uint32_t, std::size_t> FenwickFind(std::size_t position) const;
+
+  void MarkBucket(std::uint32_t bucket);
+
+  // Первая непустая корзина, не меньшая bucket, или Buckets
+  std::uint32_t NextNonempty(std::uint32_t bucket) const;
+
+  // Кусок корзины, в котором лежит или должен лежать id
+  static std::size_t ChunkOf(const Bucket& bucket, std::uint64_t uid);
+
+  // До limit id ленты, начиная с cursor
+  std::vector<std::uint64_t> Page(Cursor cursor, std::size_t limit) const;
+};
+
+}  // namespace youndex::express
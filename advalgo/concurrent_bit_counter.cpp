@@ -0,0 +1,40 @@
+#include "advalgo/concurrent_bit_counter.hpp"
+
+#include <bit>
+
+// Порядок памяти relaxed: сами операции друг от друга ничего не читают, а точное чтение Ones()
+// синхронизирует вызывающий код (join, мьютекс)
+
+void ConcurrentBitCounter::Add(const uint32_t S) {
+  uint64_t addend = uint64_t{1} << (S & 63);
+  for (size_t limb = S >> 6; limb < limbs_.size(); limb++) {
+    const uint64_t old = limbs_[limb].fetch_add(addend, std::memory_order_relaxed);
+
+    // Переполнения слова не было - перенос не нужен
+    if (old + addend >= old) {
+      return;
+    }
+    addend = 1;
+  }
+}
+
+void ConcurrentBitCounter::Subtract(const uint32_t S) {
+  uint64_t subtrahend = uint64_t{1} << (S & 63);
+  for (size_t limb = S >> 6; limb < limbs_.size(); limb++) {
+    const uint64_t old = limbs_[limb].fetch_sub(subtrahend, std::memory_order_relaxed);
+
+    // Слово не ушло ниже нуля - заем не нужен
+    if (old >= subtrahend) {
+      return;
+    }
+    subtrahend = 1;
+  }
+}
+
+uint32_t ConcurrentBitCounter::Ones() const {
+  uint32_t ones = 0;
+  for (const auto& limb : limbs_) {
+    ones += std::popcount(limb.load(std::memory_order_relaxed));
+  }
+  return ones;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/*
+
+# Общий счетчик единиц
+
+Вариант движка задачи B (advalgo/bit_counter.hpp) для числа x, которое одновременно меняют
+несколько потоков. x хранится словами по 64 разряда (limb), каждое слово - std::atomic. Прибавление
+2^S - атомарный fetch_add к слову S / 64; по старому значению слова видно, было ли переполнение, и
+тогда перенос той же операцией прибавляется к следующему слову. Вычитание аналогично распространяет
+заем. Блокировок нет, каждое слово меняется одной атомарной инструкцией.
+
+Промежуточные состояния при одновременных операциях могут быть "неправильными" (заем уже снят со
+старшего слова, а перенос от другого потока еще не дошел), но сложение по модулю 2^(64 * слов)
+коммутативно, поэтому после завершения всех операций x точно равен сумме всех изменений.
+
+Ones() считает popcount по всем словам и точен в точках синхронизации, когда изменяющие потоки
+остановлены (например, после join или под общим мьютексом вызывающего кода). Во время изменений он
+возвращает приблизительное значение.
+
+*/
+
+class ConcurrentBitCounter {
+  std::vector<std::atomic<uint64_t>> limbs_;
+
+public:
+  // size - количество разрядов, с запасом на переносы
+  explicit ConcurrentBitCounter(uint32_t size = 200000) : limbs_((size + 63) / 64) {
+  }
+
+  // x += 2^S, можно вызывать из нескольких потоков одновременно
+  void Add(uint32_t S);
+
+  // x -= 2^S, можно вызывать из нескольких потоков одновременно. После завершения всех операций x
+  // должен быть неотрицательным
+  void Subtract(uint32_t S);
+
+  // Количество единиц в двоичной записи x, точное, если никто не меняет счетчик одновременно
+  uint32_t Ones() const;
+};
@@ -0,0 +1,71 @@
+#include "advalgo/indexed_item_feed.hpp"
+
+#include <utility>
+
+namespace youndex::express {
+
+void IndexedItemFeed::Merge() {
+  // Итог журнала по каждому товару: последний рейтинг или удаление
+  std::unordered_map<std::uint64_t, std::int32_t> last;
+  last.reserve(delta_.size());
+  for (const Change& change : delta_) {
+    last[change.id] = change.score;
+  }
+
+  // Ключи (score, id), которые уходят из слоя и приходят в него
+  using Key = std::pair<std::uint16_t, std::uint64_t>;
+  std::vector<Key> erased;
+  std::vector<Key> inserted;
+  for (const auto& [id, score] : last) {
+    const auto it = scores_.find(id);
+    if (it != scores_.end()) {
+      erased.emplace_back(it->second, id);
+    }
+    if (score == Removed) {
+      if (it != scores_.end()) {
+        scores_.erase(it);
+      }
+      continue;
+    }
+    inserted.emplace_back(static_cast<std::uint16_t>(score), id);
+    scores_[id] = static_cast<std::uint16_t>(score);
+  }
+  std::sort(erased.begin(), erased.end());
+  std::sort(inserted.begin(), inserted.end());
+
+  // Слияние старого массива без erased с inserted, по пути собираются размеры непустых корзин
+  std::vector<std::uint64_t> ids;
+  ids.reserve(size_);
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> nonempty;
+  auto push = [&](const Key& key) {
+    ids.push_back(key.second);
+    if (nonempty.empty() || nonempty.back().first != key.first) {
+      nonempty.emplace_back(key.first, 0);
+    }
+    nonempty.back().second++;
+  };
+
+  auto next_erased = erased.begin();
+  auto next_inserted = inserted.begin();
+  buckets_.ForEach([&](const std::size_t position, const std::uint32_t score) {
+    const Key key(static_cast<std::uint16_t>(score), ids_[position]);
+    if (next_erased != erased.end() && *next_erased == key) {
+      ++next_erased;
+      return;
+    }
+    for (; next_inserted != inserted.end() && *next_inserted < key; ++next_inserted) {
+      push(*next_inserted);
+    }
+    push(key);
+  });
+  for (; next_inserted != inserted.end(); ++next_inserted) {
+    push(*next_inserted);
+  }
+
+  ids_ = std::move(ids);
+  buckets_ = ScoreBuckets(Buckets, nonempty);
+  delta_.clear();
+  merges_++;
+}
+
+}  // namespace youndex::express
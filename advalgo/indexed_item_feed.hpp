@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "advalgo/item_feed.hpp"
+#include "advalgo/score_buckets.hpp"
+
+/*
+
+# Лента товаров с индексом для чтения
+
+ItemFeed с дополнительным слоем для периодов, когда лента почти не меняется. Слой - это массив id,
+отсортированный по (score, id), и сжатый индекс границ корзин рейтингов (ScoreBuckets) к нему:
+- GetAtPosition - срез массива с позиции position;
+- GetAtItemWithId - рейтинг товара по id, границы его корзины из индекса и двоичный поиск id внутри
+  корзины (id в корзине отсортированы), затем срез.
+
+Изменения применяются к Treap сразу, а в слой попадают через журнал (delta_). Пока журнал не пуст,
+слой устарел, и запросы обслуживает Treap. Журнал вливается в слой одним проходом по массиву за
+O(N + B / 64 + D * log D), когда после последнего изменения прошло quiet_reads запросов (по
+умолчанию (N + B) / 32 - столько запросов окупают проход), или когда журнал стал длиннее ленты. Так
+частые изменения не тратят время на перестройку, а после затишья запросы идут по массиву.
+
+*/
+
+namespace youndex::express {
+
+class IndexedItemFeed final {
+public:
+  // quiet_reads - сколько запросов без изменений ждать перед вливанием журнала, 0 - подобрать по
+  // размеру ленты
+  explicit IndexedItemFeed(std::size_t quiet_reads = 0)
+      : quiet_reads_(quiet_reads), buckets_(Buckets, {}) {
+  }
+
+  [[nodiscard]] std::vector<std::uint64_t> GetAtPosition(std::size_t position, std::size_t limit) {
+    if (!Read()) {
+      return feed_.GetAtPosition(position, limit);
+    }
+    return Slice(position, limit);
+  }
+
+  [[nodiscard]] std::vector<std::uint64_t> GetAtItemWithId(std::uint64_t uid, std::size_t limit) {
+    if (!Read()) {
+      return feed_.GetAtItemWithId(uid, limit);
+    }
+    const std::uint16_t score = scores_.at(uid);
+    const auto begin = ids_.begin() + static_cast<std::ptrdiff_t>(buckets_.Begin(score));
+    const auto end = ids_.begin() + static_cast<std::ptrdiff_t>(buckets_.End(score));
+    return Slice(static_cast<std::size_t>(std::lower_bound(begin, end, uid) - ids_.begin()), limit);
+  }
+
+  void Add(Item item) {
+    feed_.Add(item);
+    size_++;
+    Log({item.id, item.score});
+  }
+
+  void Update(Item item) {
+    feed_.Update(item);
+    Log({item.id, item.score});
+  }
+
+  void Remove(std::uint64_t uid) {
+    feed_.Remove(uid);
+    size_--;
+    Log({uid, Removed});
+  }
+
+  // Слой чтения актуален: в журнале нет изменений
+  [[nodiscard]] bool Indexed() const {
+    return delta_.empty();
+  }
+
+  [[nodiscard]] std::size_t Merges() const {
+    return merges_;
+  }
+
+  [[nodiscard]] std::size_t IndexMemoryBytes() const {
+    return ids_.capacity() * sizeof(std::uint64_t) + buckets_.MemoryBytes();
+  }
+
+private:
+  static constexpr std::size_t Buckets = 65536;
+  static constexpr std::int32_t Removed = -1;
+
+  // Запись журнала: новый рейтинг товара или Removed
+  struct Change {
+    std::uint64_t id;
+    std::int32_t score;
+  };
+
+  ItemFeed feed_;
+  std::size_t size_ = 0;
+  std::size_t quiet_reads_;
+  std::size_t reads_since_change_ = 0;
+  std::size_t merges_ = 0;
+
+  // Слой чтения и журнал изменений, которые в него еще не попали
+  std::vector<std::uint64_t> ids_;
+  ScoreBuckets buckets_;
+  std::unordered_map<std::uint64_t, std::uint16_t> scores_;
+  std::vector<Change> delta_;
+
+  void Log(const Change& change) {
+    delta_.push_back(change);
+    reads_since_change_ = 0;
+    if (delta_.size() > std::max<std::size_t>(size_, 1024)) {
+      Merge();
+    }
+  }
+
+  // Учитывает запрос и вливает журнал после затишья. Возвращает, можно ли читать из слоя
+  bool Read() {
+    reads_since_change_++;
+    if (!delta_.empty() && reads_since_change_ >= QuietReads()) {
+      Merge();
+    }
+    return delta_.empty();
+  }
+
+  std::size_t QuietReads() const {
+    return quiet_reads_ != 0 ? quiet_reads_ : (size_ + Buckets) / 32;
+  }
+
+  std::vector<std::uint64_t> Slice(std::size_t position, std::size_t limit) const {
+    const auto begin = ids_.begin() + static_cast<std::ptrdiff_t>(position);
+    const auto end = ids_.begin() + static_cast<std::ptrdiff_t>(std::min(position + limit, size_));
+    return {begin, end};
+  }
+
+  // Вливает журнал в слой чтения одним проходом слиянием
+  void Merge();
+};
+
+}  // namespace youndex::express
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "advalgo/item_feed_stats.hpp"
+
+/*
+
+# Лента товаров
+
+Движок задачи C (подробное описание - в C.cpp): Treap по ключу (score, id) с указателями на
+родителя, размерами поддеревьев и отображением id -> вершина. Счетчики горячих путей - в
+advalgo/item_feed_stats.hpp, по умолчанию выключены.
+
+*/
+
+namespace youndex::express {
+
+struct Item {
+  std::uint64_t id;
+  std::uint16_t score;
+};
+
+class ItemFeed final {
+public:
+  ItemFeed() : root_(nullptr) {
+  }
+  ~ItemFeed() {
+    Clear(root_);
+  }
+
+  [[nodiscard]] std::vector<std::uint64_t> GetAtPosition(std::size_t position, std::size_t limit)
+      const {
+    assert(position < Size());
+    assert(1 <= limit && limit <= 16);
+    const stats::OperationProbe probe(FeedOperation::AtPosition);
+
+    std::vector<std::uint64_t> result;
+    result.reserve(limit);
+
+    Node* node = Kth(root_, position);
+    for (std::size_t i = 0; i < limit && node != nullptr; ++i) {
+      result.push_back(node->item.id);
+      node = Successor(node);
+    }
+    return result;
+  }
+
+  [[nodiscard]] std::vector<std::uint64_t> GetAtItemWithId(std::uint64_t uid, std::size_t limit)
+      const {
+    assert(Contains(uid));
+    assert(1 <= limit && limit <= 16);
+    const stats::OperationProbe probe(FeedOperation::AtId);
+
+    std::vector<std::uint64_t> result;
+    result.reserve(limit);
+
+    Node* node = id_map_.at(uid);
+    if constexpr (stats::Enabled) {
+      stats::ReachDepth(Depth(node));
+    }
+    for (std::size_t i = 0; i < limit && node != nullptr; ++i) {
+      result.push_back(node->item.id);
+      node = Successor(node);
+    }
+    return result;
+  }
+
+  void Add(Item item) {
+    assert(!Contains(item.id));
+    const stats::OperationProbe probe(FeedOperation::Add);
+    root_ = Insert(root_, new Node(item), nullptr);
+  }
+
+  void Update(Item item) {
+    assert(Contains(item.id));
+    const stats::OperationProbe probe(FeedOperation::Update);
+    Remove(item.id);
+    Add(item);
+  }
+
+  // Статистика горячих путей (см. advalgo/item_feed_stats.hpp) и заполненность id_map_
+  [[nodiscard]] ItemFeedStats Stats() const {
+    ItemFeedStats result = stats::Collect();
+    result.id_map_size = id_map_.size();
+    result.id_map_buckets = id_map_.bucket_count();
+    return result;
+  }
+
+  void Remove(std::uint64_t uid) {
+    assert(Contains(uid));
+    const stats::OperationProbe probe(FeedOperation::Remove);
+    Item key = id_map_.at(uid)->item;
+    root_ = Erase(root_, key);
+  }
+
+private:
+  struct Node {
+    Item item;
+    Node* left = nullptr;
+    Node* right = nullptr;
+    Node* parent = nullptr;
+    std::size_t subtree_size = 1;
+    int priority;
+    explicit Node(const Item& it) : item(it), priority(rand_dist(rand_eng)) {
+    }
+  };
+
+  Node* root_;
+  std::unordered_map<std::uint64_t, Node*> id_map_;
+
+  static bool KeyLess(const Item& a, const Item& b) {
+    return a.score != b.score ? a.score < b.score : a.id < b.id;
+  }
+
+  static bool KeyEqual(const Item& a, const Item& b) {
+    return a.score == b.score && a.id == b.id;
+  }
+
+  [[nodiscard]] bool Contains(std::uint64_t uid) const {
+    return id_map_.find(uid) != id_map_.end();
+  }
+
+  [[nodiscard]] std::size_t Size() const {
+    return SubtreeSize(root_);
+  }
+
+  static std::size_t SubtreeSize(const Node* n) {
+    return n ? n->subtree_size : 0;
+  }
+
+  static void Update(Node* n) {
+    if (!n)
+      return;
+    n->subtree_size = 1 + SubtreeSize(n->left) + SubtreeSize(n->right);
+    if (n->left)
+      n->left->parent = n;
+    if (n->right)
+      n->right->parent = n;
+  }
+
+  // Treap split/merge
+  static void Split(Node* t, const Item& key, Node*& left, Node*& right) {
+    const stats::RecursionProbe<stats::Recursion::Split> probe;
+    if (!t) {
+      left = right = nullptr;
+      return;
+    }
+    if (KeyLess(t->item, key) || KeyEqual(t->item, key)) {
+      Split(t->right, key, t->right, right);
+      left = t;
+    } else {
+      Split(t->left, key, left, t->left);
+      right = t;
+    }
+    Update(t);
+  }
+
+  static Node* Merge(Node* left, Node* right) {
+    const stats::RecursionProbe<stats::Recursion::Merge> probe;
+    if (!left)
+      return right;
+    if (!right)
+      return left;
+    if (left->priority > right->priority) {
+      left->right = Merge(left->right, right);
+      Update(left);
+      return left;
+    } else {
+      right->left = Merge(left, right->left);
+      Update(right);
+      return right;
+    }
+  }
+
+  Node* Insert(Node* root, Node* node, Node* parent) {
+    const stats::RecursionProbe<stats::Recursion::Tree> probe;
+    if (!root) {
+      node->parent = parent;
+      id_map_[node->item.id] = node;
+      return node;
+    }
+    if (node->priority > root->priority) {
+      Split(root, node->item, node->left, node->right);
+      node->parent = parent;
+      if (node->left)
+        node->left->parent = node;
+      if (node->right)
+        node->right->parent = node;
+      Update(node);
+      id_map_[node->item.id] = node;
+      return node;
+    } else if (KeyLess(node->item, root->item)) {
+      root->left = Insert(root->left, node, root);
+    } else {
+      root->right = Insert(root->right, node, root);
+    }
+    Update(root);
+    return root;
+  }
+
+  Node* Erase(Node* root, const Item& key) {
+    const stats::RecursionProbe<stats::Recursion::Tree> probe;
+    if (!root)
+      return nullptr;
+    if (KeyEqual(root->item, key)) {
+      id_map_.erase(root->item.id);
+      Node* merged = Merge(root->left, root->right);
+      if (merged)
+        merged->parent = root->parent;
+      delete root;
+      return merged;
+    } else if (KeyLess(key, root->item)) {
+      root->left = Erase(root->left, key);
+      if (root->left)
+        root->left->parent = root;
+    } else {
+      root->right = Erase(root->right, key);
+      if (root->right)
+        root->right->parent = root;
+    }
+    Update(root);
+    return root;
+  }
+
+  static Node* Kth(Node* root, std::size_t k) {
+    const stats::RecursionProbe<stats::Recursion::Tree> probe;
+    if (!root)
+      return nullptr;
+    std::size_t left_size = SubtreeSize(root->left);
+    if (k < left_size)
+      return Kth(root->left, k);
+    else if (k == left_size)
+      return root;
+    else
+      return Kth(root->right, k - left_size - 1);
+  }
+
+  // Successor using parent pointers
+  static Node* Successor(Node* node) {
+    if (!node)
+      return nullptr;
+    if (node->right) {
+      node = node->right;
+      stats::CountStep();
+      while (node->left) {
+        node = node->left;
+        stats::CountStep();
+      }
+      return node;
+    }
+    Node* parent = node->parent;
+    stats::CountStep();
+    while (parent && node == parent->right) {
+      node = parent;
+      parent = parent->parent;
+      stats::CountStep();
+    }
+    return parent;
+  }
+
+  // Количество ребер от вершины до корня, только для статистики
+  static std::size_t Depth(const Node* node) {
+    std::size_t depth = 0;
+    for (; node->parent != nullptr; node = node->parent) {
+      depth++;
+    }
+    return depth;
+  }
+
+  static void Clear(Node* node) {
+    if (!node)
+      return;
+    Clear(node->left);
+    Clear(node->right);
+    delete node;
+  }
+
+  // Random engine for treap priority
+  static inline std::mt19937 rand_eng{std::random_device{}()};
+  static inline std::uniform_int_distribution<int> rand_dist{1, 1'000'000'000};
+};
+
+}  // namespace youndex::express
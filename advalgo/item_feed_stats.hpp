@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef ADVALGO_ITEM_FEED_STATS
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif
+
+/*
+
+# Статистика ленты товаров
+
+Счетчики горячих путей ItemFeed (advalgo/item_feed.hpp). Включаются только при сборке с макросом
+ADVALGO_ITEM_FEED_STATS (цель C_stats в CMake). Без него все пробы - пустые классы и функции, и код
+ItemFeed после оптимизации совпадает с кодом без статистики. Макрос должен быть одним и тем же во
+всей программе, поэтому C_stats линкуется с отдельной библиотекой advalgo_stats.
+
+Собирается:
+- глубина дерева, до которой дошла каждая публичная операция (для Update - максимум по удалению и
+  вставке, для GetAtItemWithId - глубина найденной вершины);
+- количество шагов Successor на одну страницу GetAtPosition/GetAtItemWithId;
+- глубина рекурсии Split и Merge на один внешний вызов;
+- заполненность id_map_ (считается по запросу, а не на горячем пути).
+
+Счетчики у каждого потока свои: поток обновляет их без блокировок обычными load/store, а
+ItemFeed::Stats() под мьютексом суммирует счетчики всех живых потоков и уже завершившихся. Счетчики
+общие для всех экземпляров ItemFeed потока, заполненность id_map_ - конкретного экземпляра.
+
+*/
+
+namespace youndex::express {
+
+enum class FeedOperation : std::size_t { Add, Update, Remove, AtPosition, AtId };
+
+constexpr std::size_t FeedOperations = 5;
+
+// Снимок статистики. Последний столбец каждой гистограммы - значения не меньше Buckets - 1
+struct ItemFeedStats {
+  static constexpr std::size_t Buckets = 128;
+  using Histogram = std::array<std::uint64_t, Buckets>;
+
+  bool enabled = false;
+  std::array<Histogram, FeedOperations> depth{};
+  Histogram successor_steps{};
+  Histogram split_depth{};
+  Histogram merge_depth{};
+  std::size_t id_map_size = 0;
+  std::size_t id_map_buckets = 0;
+
+  double LoadFactor() const {
+    return id_map_buckets == 0 ? 0.0 : static_cast<double>(id_map_size) / id_map_buckets;
+  }
+
+  // Печатает по строке на гистограмму: количество, среднее, медиану, 99-й перцентиль и максимум
+  void Dump(std::FILE* out) const {
+    if (enabled) {
+      DumpHistograms(out);
+    } else {
+      std::fprintf(out, "item feed stats: disabled (build with ADVALGO_ITEM_FEED_STATS)\n");
+    }
+    std::fprintf(out, "id_map: size=%zu buckets=%zu load_factor=%.3f\n", id_map_size,
+                 id_map_buckets, LoadFactor());
+  }
+
+private:
+  void DumpHistograms(std::FILE* out) const {
+    static constexpr std::array<const char*, FeedOperations> Names = {
+        "add", "update", "remove", "at_position", "at_id"
+    };
+    for (std::size_t op = 0; op < FeedOperations; op++) {
+      DumpHistogram(out, "depth.", Names[op], depth[op]);
+    }
+    DumpHistogram(out, "successor_steps", "", successor_steps);
+    DumpHistogram(out, "split_depth", "", split_depth);
+    DumpHistogram(out, "merge_depth", "", merge_depth);
+  }
+
+  static void DumpHistogram(
+      std::FILE* out,
+      const char* name,
+      const char* suffix,
+      const Histogram& histogram
+  ) {
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::size_t max = 0;
+    for (std::size_t i = 0; i < Buckets; i++) {
+      count += histogram[i];
+      sum += histogram[i] * i;
+      if (histogram[i] > 0) {
+        max = i;
+      }
+    }
+
+    auto percentile = [&](double q) {
+      std::uint64_t seen = 0;
+      for (std::size_t i = 0; i < Buckets; i++) {
+        seen += histogram[i];
+        if (seen > 0 && seen >= q * count) {
+          return i;
+        }
+      }
+      return Buckets - 1;
+    };
+
+    std::fprintf(out, "%s%s: count=%llu mean=%.2f p50=%zu p99=%zu max=%zu\n", name, suffix,
+                 static_cast<unsigned long long>(count),
+                 count == 0 ? 0.0 : static_cast<double>(sum) / count, percentile(0.5),
+                 percentile(0.99), max);
+  }
+};
+
+namespace stats {
+
+enum class Recursion : std::size_t { Tree, Split, Merge };
+
+#ifdef ADVALGO_ITEM_FEED_STATS
+
+constexpr bool Enabled = true;
+
+// Счетчики одного потока. Гистограммы атомарные только ради чтения из ItemFeed::Stats(): владелец
+// обновляет их через relaxed load/store, это обычные mov без lock-префикса
+struct Counters {
+  using Histogram = std::array<std::atomic<std::uint64_t>, ItemFeedStats::Buckets>;
+
+  std::array<Histogram, FeedOperations> depth{};
+  Histogram successor_steps{};
+  Histogram split_depth{};
+  Histogram merge_depth{};
+
+  // Состояние текущей операции, его видит только сам поток
+  std::size_t operations = 0;  // вложенность публичных операций (Update вызывает Remove и Add)
+  std::size_t steps = 0;
+  std::array<std::size_t, 3> level{};
+  std::array<std::size_t, 3> max_level{};
+
+  static void Bump(Histogram& histogram, std::size_t value) {
+    auto& counter = histogram[std::min(value, ItemFeedStats::Buckets - 1)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void AddTo(ItemFeedStats& stats) const {
+    auto add = [](ItemFeedStats::Histogram& to, const Histogram& from) {
+      for (std::size_t i = 0; i < ItemFeedStats::Buckets; i++) {
+        to[i] += from[i].load(std::memory_order_relaxed);
+      }
+    };
+    for (std::size_t op = 0; op < FeedOperations; op++) {
+      add(stats.depth[op], depth[op]);
+    }
+    add(stats.successor_steps, successor_steps);
+    add(stats.split_depth, split_depth);
+    add(stats.merge_depth, merge_depth);
+  }
+};
+
+// Счетчики всех потоков. Счетчики завершившегося потока прибавляются к retired_
+class Registry {
+  std::mutex mutex_;
+  std::vector<const Counters*> live_;
+  ItemFeedStats retired_;
+
+public:
+  static Registry& Instance() {
+    static Registry registry;
+    return registry;
+  }
+
+  void Attach(const Counters* counters) {
+    const std::lock_guard lock(mutex_);
+    live_.push_back(counters);
+  }
+
+  void Detach(const Counters* counters) {
+    const std::lock_guard lock(mutex_);
+    counters->AddTo(retired_);
+    live_.erase(std::find(live_.begin(), live_.end(), counters));
+  }
+
+  ItemFeedStats Collect() {
+    const std::lock_guard lock(mutex_);
+    ItemFeedStats result = retired_;
+    for (const Counters* counters : live_) {
+      counters->AddTo(result);
+    }
+    result.enabled = true;
+    return result;
+  }
+};
+
+inline Counters& Local() {
+  struct LocalCounters : Counters {
+    LocalCounters() {
+      Registry::Instance().Attach(this);
+    }
+    ~LocalCounters() {
+      Registry::Instance().Detach(this);
+    }
+  };
+  thread_local LocalCounters counters;
+  return counters;
+}
+
+inline ItemFeedStats Collect() {
+  return Registry::Instance().Collect();
+}
+
+// Публичная операция: записывает глубину дерева и шаги Successor, если операция не вложенная
+class OperationProbe {
+  FeedOperation op_;
+
+public:
+  explicit OperationProbe(FeedOperation op) : op_(op) {
+    Counters& counters = Local();
+    if (counters.operations++ == 0) {
+      counters.steps = 0;
+      counters.max_level[static_cast<std::size_t>(Recursion::Tree)] = 0;
+    }
+  }
+
+  ~OperationProbe() {
+    Counters& counters = Local();
+    if (--counters.operations > 0) {
+      return;
+    }
+    auto& depth = counters.max_level[static_cast<std::size_t>(Recursion::Tree)];
+    Counters::Bump(counters.depth[static_cast<std::size_t>(op_)], depth);
+    if (op_ == FeedOperation::AtPosition || op_ == FeedOperation::AtId) {
+      Counters::Bump(counters.successor_steps, counters.steps);
+    }
+  }
+};
+
+// Один уровень рекурсии. Для Split и Merge по выходу из внешнего вызова записывается его глубина
+template <Recursion R>
+class RecursionProbe {
+  static constexpr auto Index = static_cast<std::size_t>(R);
+
+public:
+  RecursionProbe() {
+    Counters& counters = Local();
+    counters.max_level[Index] = std::max(counters.max_level[Index], ++counters.level[Index]);
+  }
+
+  ~RecursionProbe() {
+    Counters& counters = Local();
+    if (--counters.level[Index] > 0 || R == Recursion::Tree) {
+      return;
+    }
+    Counters::Bump(R == Recursion::Split ? counters.split_depth : counters.merge_depth,
+                   counters.max_level[Index]);
+    counters.max_level[Index] = 0;
+  }
+};
+
+// Глубина, до которой дошла текущая операция без рекурсии (например, поиск вершины по id)
+inline void ReachDepth(std::size_t depth) {
+  auto& max_level = Local().max_level[static_cast<std::size_t>(Recursion::Tree)];
+  max_level = std::max(max_level, depth);
+}
+
+inline void CountStep() {
+  Local().steps++;
+}
+
+#else
+
+constexpr bool Enabled = false;
+
+inline ItemFeedStats Collect() {
+  return {};
+}
+
+class OperationProbe {
+public:
+  explicit OperationProbe(FeedOperation) {
+  }
+};
+
+template <Recursion R>
+class RecursionProbe {
+public:
+  RecursionProbe() {
+  }
+};
+
+inline void ReachDepth(std::size_t) {
+}
+
+inline void CountStep() {
+}
+
+#endif
+
+}  // namespace stats
+
+}  // namespace youndex::express
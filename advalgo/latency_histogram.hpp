@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/*
+
+# Гистограмма задержек
+
+Гистограмма в духе HdrHistogram: значения до 2^SubBucketBits хранятся точно, а каждый следующий
+отрезок [2^e, 2^(e+1)) делится на 2^SubBucketBits равных корзин. Относительная ошибка перцентиля -
+не больше 2^-SubBucketBits (около 3%) на всем диапазоне uint64, память - 1920 счетчиков, запись -
+bit_width и сдвиг без ветвлений по диапазону.
+
+*/
+
+class LatencyHistogram {
+  static constexpr uint32_t SubBucketBits = 5;
+  static constexpr uint32_t SubBuckets = 1 << SubBucketBits;
+
+  std::vector<uint64_t> counts_;
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+
+public:
+  LatencyHistogram() : counts_(SubBuckets + (64 - SubBucketBits) * SubBuckets, 0) {
+  }
+
+  void Record(const uint64_t value) {
+    counts_[IndexOf(value)]++;
+    count_++;
+    sum_ += value;
+    max_ = std::max(max_, value);
+  }
+
+  uint64_t Count() const {
+    return count_;
+  }
+
+  uint64_t Max() const {
+    return max_;
+  }
+
+  double Mean() const {
+    return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_;
+  }
+
+  // Наибольшее значение корзины, в которую попал q-перцентиль (q от 0 до 1)
+  uint64_t Percentile(const double q) const {
+    uint64_t seen = 0;
+    for (size_t index = 0; index < counts_.size(); index++) {
+      seen += counts_[index];
+      if (seen > 0 && seen >= q * count_) {
+        return std::min(HighestOf(index), max_);
+      }
+    }
+    return max_;
+  }
+
+  // Строка отчета: количество, среднее, p50, p99, p999 и максимум
+  void Dump(std::FILE* out, const char* name) const {
+    std::fprintf(out, "%s: count=%llu mean=%.1f p50=%llu p99=%llu p999=%llu max=%llu\n", name,
+                 static_cast<unsigned long long>(count_), Mean(),
+                 static_cast<unsigned long long>(Percentile(0.5)),
+                 static_cast<unsigned long long>(Percentile(0.99)),
+                 static_cast<unsigned long long>(Percentile(0.999)),
+                 static_cast<unsigned long long>(max_));
+  }
+
+private:
+  static size_t IndexOf(const uint64_t value) {
+    if (value < SubBuckets) {
+      return value;
+    }
+    const uint32_t shift = std::bit_width(value) - 1 - SubBucketBits;
+    return SubBuckets + size_t{shift} * SubBuckets + ((value >> shift) - SubBuckets);
+  }
+
+  static uint64_t HighestOf(const size_t index) {
+    if (index < SubBuckets) {
+      return index;
+    }
+    const size_t shift = (index - SubBuckets) / SubBuckets;
+    const uint64_t lowest = (SubBuckets + (index - SubBuckets) % SubBuckets) << shift;
+    return lowest + ((uint64_t{1} << shift) - 1);
+  }
+};
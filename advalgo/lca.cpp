@@ -0,0 +1,240 @@
+#include "advalgo/lca.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// Наименьшее levels >= 1 с 2^levels > n: глубина вершины меньше n
+int32_t LevelsFor(const int32_t n) {
+  return std::max(1, static_cast<int32_t>(std::bit_width(static_cast<uint32_t>(n))));
+}
+
+}  // namespace
+
+LcaTable::LcaTable(const Tree& tree, const bool with_aggregates)
+    : levels_(LevelsFor(tree.Size())), up_(tree.Size(), std::vector<int32_t>(levels_)) {
+  const int32_t n = tree.Size();
+  if (n == 0) {
+    return;
+  }
+
+  // DFS для depth[] и up[][0]
+  Traversal dfs = Dfs(tree, 0);
+  depth_ = std::move(dfs.depth);
+  for (int32_t v : dfs.order) {
+    up_[v][0] = dfs.parent[v] == -1 ? v : dfs.parent[v];
+  }
+
+  // Заполняем таблицу подъёмов up[v][k]
+  for (int32_t k = 1; k < levels_; k++) {
+    for (int32_t v = 0; v < n; v++) {
+      up_[v][k] = up_[up_[v][k - 1]][k - 1];
+    }
+  }
+
+  if (!with_aggregates) {
+    return;
+  }
+
+  // Вес ребра в родителя восстанавливается из xor-префиксов обхода: w = xor[v] ^ xor[parent]. У
+  // корня ребра нет, его подъем никогда не используется в запросах
+  xor_prefix_ = std::move(dfs.xor_prefix);
+  sum_prefix_.assign(n, 0);
+  up_max_.assign(n, std::vector<int32_t>(levels_));
+  up_min_.assign(n, std::vector<int32_t>(levels_));
+  for (int32_t v : dfs.order) {
+    const int32_t parent = up_[v][0];
+    const int32_t weight = xor_prefix_[v] ^ xor_prefix_[parent];
+    sum_prefix_[v] = parent == v ? 0 : sum_prefix_[parent] + weight;
+    up_max_[v][0] = weight;
+    up_min_[v][0] = weight;
+  }
+  for (int32_t k = 1; k < levels_; k++) {
+    for (int32_t v = 0; v < n; v++) {
+      const int32_t mid = up_[v][k - 1];
+      up_max_[v][k] = std::max(up_max_[v][k - 1], up_max_[mid][k - 1]);
+      up_min_[v][k] = std::min(up_min_[v][k - 1], up_min_[mid][k - 1]);
+    }
+  }
+}
+
+PathAggregate LcaTable::Aggregate(int32_t a, int32_t b) const {
+  int32_t max_weight = std::numeric_limits<int32_t>::min();
+  int32_t min_weight = std::numeric_limits<int32_t>::max();
+
+  // Подъем v на 2^k вместе с учетом весов пройденных ребер
+  auto jump = [&](int32_t& v, int32_t k) {
+    max_weight = std::max(max_weight, up_max_[v][k]);
+    min_weight = std::min(min_weight, up_min_[v][k]);
+    v = up_[v][k];
+  };
+
+  if (depth_[a] < depth_[b]) {
+    std::swap(a, b);
+  }
+  int32_t lca = a;
+  int32_t other = b;
+  const int32_t h = depth_[a] - depth_[b];
+  for (int32_t k = 0; k < levels_; k++) {
+    if (h & (1 << k)) {
+      jump(lca, k);
+    }
+  }
+  if (lca != other) {
+    for (int32_t k = levels_ - 1; k >= 0; k--) {
+      if (up_[lca][k] != up_[other][k]) {
+        jump(lca, k);
+        jump(other, k);
+      }
+    }
+    jump(lca, 0);
+    jump(other, 0);
+  }
+
+  PathAggregate result;
+  result.edges = depth_[a] + depth_[b] - 2 * depth_[lca];
+  if (result.edges > 0) {
+    result.max_weight = max_weight;
+    result.min_weight = min_weight;
+  }
+  result.sum = sum_prefix_[a] + sum_prefix_[b] - 2 * sum_prefix_[lca];
+  result.xor_sum = PathXor(a, b);
+  return result;
+}
+
+int32_t LcaTable::Lca(int32_t a, int32_t b) const {
+  if (depth_[a] < depth_[b]) {
+    std::swap(a, b);
+  }
+
+  a = Lift(a, depth_[a] - depth_[b]);
+  if (a == b)
+    return a;
+
+  for (int32_t k = levels_ - 1; k >= 0; k--) {
+    if (up_[a][k] != up_[b][k]) {
+      a = up_[a][k];
+      b = up_[b][k];
+    }
+  }
+  return up_[a][0];
+}
+
+int32_t LcaTable::Lift(int32_t v, int32_t h) const {
+  for (int32_t k = 0; k < levels_; k++) {
+    if (h & (1 << k)) {
+      v = up_[v][k];
+    }
+  }
+  return v;
+}
+
+void LinkCutTree::Link(int32_t u, int32_t v) {
+  MakeRoot(u);
+  parent_[u] = v;
+}
+
+void LinkCutTree::Cut(int32_t u, int32_t v) {
+  MakeRoot(u);
+  Access(v);
+  // Путь u -> v состоит из двух вершин, значит левое поддерево v - это ровно u
+  ch_[v][0] = -1;
+  parent_[u] = -1;
+  Pull(v);
+}
+
+int32_t LinkCutTree::Distance(int32_t u, int32_t v) {
+  if (u == v) {
+    return 0;
+  }
+  MakeRoot(u);
+  if (FindRoot(v) != u) {
+    return -1;
+  }
+  Access(v);
+  return size_[v] - 1;
+}
+
+void LinkCutTree::Push(int32_t x) {
+  if (rev_[x] == 0) {
+    return;
+  }
+  std::swap(ch_[x][0], ch_[x][1]);
+  for (int32_t c : ch_[x]) {
+    if (c != -1) {
+      rev_[c] ^= 1;
+    }
+  }
+  rev_[x] = 0;
+}
+
+void LinkCutTree::Rotate(int32_t x) {
+  const int32_t y = parent_[x];
+  const int32_t z = parent_[y];
+  const int32_t dir = ch_[y][1] == x ? 1 : 0;
+
+  if (!IsRoot(y)) {
+    ch_[z][ch_[z][1] == y ? 1 : 0] = x;
+  }
+  parent_[x] = z;
+
+  ch_[y][dir] = ch_[x][dir ^ 1];
+  if (ch_[y][dir] != -1) {
+    parent_[ch_[y][dir]] = y;
+  }
+  ch_[x][dir ^ 1] = y;
+  parent_[y] = x;
+
+  Pull(y);
+  Pull(x);
+}
+
+void LinkCutTree::Splay(int32_t x) {
+  // Сначала проталкиваем отложенные развороты сверху вниз
+  stack_.clear();
+  stack_.push_back(x);
+  for (int32_t y = x; !IsRoot(y); y = parent_[y]) {
+    stack_.push_back(parent_[y]);
+  }
+  while (!stack_.empty()) {
+    Push(stack_.back());
+    stack_.pop_back();
+  }
+
+  while (!IsRoot(x)) {
+    const int32_t y = parent_[x];
+    if (!IsRoot(y)) {
+      const int32_t z = parent_[y];
+      Rotate((ch_[y][0] == x) != (ch_[z][0] == y) ? x : y);
+    }
+    Rotate(x);
+  }
+}
+
+void LinkCutTree::Access(int32_t x) {
+  for (int32_t last = -1, y = x; y != -1; last = y, y = parent_[y]) {
+    Splay(y);
+    ch_[y][1] = last;
+    Pull(y);
+  }
+  Splay(x);
+}
+
+void LinkCutTree::MakeRoot(int32_t x) {
+  Access(x);
+  rev_[x] ^= 1;
+}
+
+int32_t LinkCutTree::FindRoot(int32_t x) {
+  Access(x);
+  Push(x);
+  while (ch_[x][0] != -1) {
+    x = ch_[x][0];
+    Push(x);
+  }
+  Splay(x);
+  return x;
+}
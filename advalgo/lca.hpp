@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "advalgo/tree.hpp"
+
+/*
+
+# Расстояния в дереве
+
+Движки задачи H (подробное описание - в H.cpp):
+- LcaTable - двоичный подъем по статическому дереву: O(N log N) на построение, O(log N) на запрос.
+  Количество уровней подъема считается по N при построении (глубина меньше N < 2^levels), так что
+  ограничения на размер дерева нет.
+  По запросу при построении рядом с up хранятся максимум и минимум весов ребер на каждом подъеме
+  на 2^k, а для вершин - xor и сумма весов от корня. Тогда Aggregate(u, v) считает максимум,
+  минимум, сумму и xor весов на пути за O(log N) тем же подъемом, что и Lca, а PathXor - за O(1);
+- LinkCutTree - динамический лес с добавлением и удалением ребер за амортизированное O(log N).
+
+*/
+
+// Веса ребер пути. Для пустого пути (u == v) max_weight и min_weight равны -1
+struct PathAggregate {
+  int32_t edges = 0;
+  int32_t max_weight = -1;
+  int32_t min_weight = -1;
+  int64_t sum = 0;
+  int32_t xor_sum = 0;
+};
+
+class LcaTable {
+  int32_t levels_;  // up[v][k] для k < levels_, 2^levels_ > N
+  std::vector<std::vector<int32_t>> up_;
+  std::vector<int32_t> depth_;
+
+  // Только при построении с with_aggregates: максимум и минимум весов 2^k ребер над вершиной
+  std::vector<std::vector<int32_t>> up_max_;
+  std::vector<std::vector<int32_t>> up_min_;
+  std::vector<int32_t> xor_prefix_;
+  std::vector<int64_t> sum_prefix_;
+
+public:
+  // Веса ребер (неотрицательные) нужны только для агрегатов пути
+  explicit LcaTable(const Tree& tree, bool with_aggregates = false);
+
+  int32_t Lca(int32_t a, int32_t b) const;
+
+  int32_t Distance(int32_t a, int32_t b) const {
+    return depth_[a] + depth_[b] - 2 * depth_[Lca(a, b)];
+  }
+
+  // Агрегаты весов на пути a - b, только для таблицы с with_aggregates
+  PathAggregate Aggregate(int32_t a, int32_t b) const;
+
+  // xor весов на пути a - b: общая часть путей от корня сокращается
+  int32_t PathXor(int32_t a, int32_t b) const {
+    return xor_prefix_[a] ^ xor_prefix_[b];
+  }
+
+private:
+  // Функция подъёма
+  int32_t Lift(int32_t v, int32_t h) const;
+};
+
+// Link-Cut дерево для динамического леса. Вершины хранятся в массивах, -1 означает отсутствие
+class LinkCutTree {
+  std::vector<std::array<int32_t, 2>> ch_;
+  std::vector<int32_t> parent_;
+  std::vector<int32_t> size_;
+  std::vector<uint8_t> rev_;
+  std::vector<int32_t> stack_;
+
+public:
+  explicit LinkCutTree(int32_t n)
+      : ch_(n, {-1, -1}), parent_(n, -1), size_(n, 1), rev_(n, 0) {
+  }
+
+  void Link(int32_t u, int32_t v);
+
+  void Cut(int32_t u, int32_t v);
+
+  // Количество ребер между u и v или -1, если вершины лежат в разных деревьях
+  int32_t Distance(int32_t u, int32_t v);
+
+private:
+  int32_t Size(int32_t x) const {
+    return x == -1 ? 0 : size_[x];
+  }
+
+  bool IsRoot(int32_t x) const {
+    const int32_t p = parent_[x];
+    return p == -1 || (ch_[p][0] != x && ch_[p][1] != x);
+  }
+
+  void Pull(int32_t x) {
+    size_[x] = 1 + Size(ch_[x][0]) + Size(ch_[x][1]);
+  }
+
+  void Push(int32_t x);
+
+  void Rotate(int32_t x);
+
+  void Splay(int32_t x);
+
+  // Делает путь от корня до x предпочтительным, после вызова x - корень своего splay-дерева
+  void Access(int32_t x);
+
+  void MakeRoot(int32_t x);
+
+  int32_t FindRoot(int32_t x);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/*
+
+# Разбор входа
+
+Общие помощники для решений, которые читают вход целиком в память и разбирают его прямо из буфера
+(0, C, H): без std::cin и без промежуточных строк. Указатель ptr продвигается по буферу до end.
+
+*/
+
+// Пропускает все символы до ближайшего числа. Возвращает false, если чисел больше нет
+inline bool SkipToNumber(const char*& ptr, const char* end) {
+  while (ptr < end && (*ptr < '0' || *ptr > '9')) {
+    ptr++;
+  }
+  return ptr < end;
+}
+
+// Следующее неотрицательное число; 0, если чисел больше нет
+inline uint64_t ReadNumber(const char*& ptr, const char* end) {
+  SkipToNumber(ptr, end);
+  uint64_t value = 0;
+  while (ptr < end && *ptr >= '0' && *ptr <= '9') {
+    value = value * 10 + (*ptr - '0');
+    ptr++;
+  }
+  return value;
+}
+
+// Следующий символ после пробелов и переводов строк (тип операции); 0 в конце буфера
+inline char ReadOp(const char*& ptr, const char* end) {
+  while (ptr < end && (*ptr == ' ' || *ptr == '\n' || *ptr == '\r')) {
+    ptr++;
+  }
+  return ptr < end ? *ptr++ : 0;
+}
+
+// Конец блока из count строк, начинающегося в ptr: запись занимает одну строку. Пустые строки (из
+// пробелов и '\r') записями не считаются, как и при разборе самих записей
+inline const char* SkipLines(const char* ptr, const char* end, uint64_t count) {
+  for (; count > 0; count--) {
+    while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\n')) {
+      ptr++;
+    }
+    if (ptr == end) {
+      break;
+    }
+    const void* newline = std::memchr(ptr, '\n', end - ptr);
+    ptr = newline != nullptr ? static_cast<const char*>(newline) + 1 : end;
+  }
+  return ptr;
+}
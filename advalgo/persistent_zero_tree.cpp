@@ -0,0 +1,130 @@
+#include "advalgo/persistent_zero_tree.hpp"
+
+PersistentZeroTree::PersistentZeroTree(const std::vector<uint32_t>& source)
+    : size_(static_cast<uint32_t>(source.size())) {
+  nodes_.reserve(2 * size_);
+  roots_.push_back(Build(source, 0, size_));
+}
+
+uint32_t PersistentZeroTree::Update(const uint32_t index, const uint32_t new_value) {
+  const uint32_t idx = index - 1;
+  const uint32_t zero = new_value == 0 ? 1 : 0;
+  const uint32_t root = roots_.back();
+
+  // Находим лист в последней версии
+  uint32_t node = root;
+  uint32_t lo = 0;
+  uint32_t hi = size_;
+  while (hi - lo > 1) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (idx < mid) {
+      node = nodes_[node].left;
+      hi = mid;
+    } else {
+      node = nodes_[node].right;
+      lo = mid;
+    }
+  }
+
+  roots_.push_back(nodes_[node].zeros == zero ? root : Set(root, 0, size_, idx, zero));
+  return Versions() - 1;
+}
+
+int32_t PersistentZeroTree::Search(
+    const uint32_t version,
+    const uint32_t left_bound,
+    const uint32_t right_bound,
+    const uint32_t k_value
+) const {
+  if (left_bound > right_bound || version >= Versions()) {
+    return -1;
+  }
+
+  // k-тый ноль отрезка - это (нули до left_bound + k)-тый ноль всего массива
+  const uint32_t root = roots_[version];
+  const uint64_t target = uint64_t{ZerosBefore(root, left_bound - 1)} + k_value;
+  if (nodes_[root].zeros < target) {
+    return -1;
+  }
+
+  uint32_t rank = static_cast<uint32_t>(target);
+  uint32_t node = root;
+  uint32_t lo = 0;
+  uint32_t hi = size_;
+  while (hi - lo > 1) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const uint32_t left_zeros = nodes_[nodes_[node].left].zeros;
+    if (rank <= left_zeros) {
+      node = nodes_[node].left;
+      hi = mid;
+    } else {
+      rank -= left_zeros;
+      node = nodes_[node].right;
+      lo = mid;
+    }
+  }
+
+  return lo < right_bound ? static_cast<int32_t>(lo + 1) : -1;
+}
+
+uint32_t PersistentZeroTree::Build(
+    const std::vector<uint32_t>& source,
+    const uint32_t lo,
+    const uint32_t hi
+) {
+  if (hi - lo == 1) {
+    nodes_.push_back({0, 0, source[lo] == 0 ? 1U : 0U});
+    return static_cast<uint32_t>(nodes_.size() - 1);
+  }
+
+  const uint32_t mid = lo + (hi - lo) / 2;
+  const uint32_t left = Build(source, lo, mid);
+  const uint32_t right = Build(source, mid, hi);
+  nodes_.push_back({left, right, nodes_[left].zeros + nodes_[right].zeros});
+  return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+uint32_t PersistentZeroTree::Set(
+    const uint32_t node,
+    const uint32_t lo,
+    const uint32_t hi,
+    const uint32_t idx,
+    const uint32_t zero
+) {
+  if (hi - lo == 1) {
+    nodes_.push_back({0, 0, zero});
+    return static_cast<uint32_t>(nodes_.size() - 1);
+  }
+
+  // Номера детей копируем до рекурсии: push_back может переложить nodes_
+  const uint32_t mid = lo + (hi - lo) / 2;
+  uint32_t left = nodes_[node].left;
+  uint32_t right = nodes_[node].right;
+  if (idx < mid) {
+    left = Set(left, lo, mid, idx, zero);
+  } else {
+    right = Set(right, mid, hi, idx, zero);
+  }
+  nodes_.push_back({left, right, nodes_[left].zeros + nodes_[right].zeros});
+  return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+uint32_t PersistentZeroTree::ZerosBefore(const uint32_t root, const uint32_t pos) const {
+  uint32_t zeros = 0;
+  uint32_t node = root;
+  uint32_t lo = 0;
+  uint32_t hi = size_;
+  while (hi - lo > 1 && pos > lo) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (pos < mid) {
+      node = nodes_[node].left;
+      hi = mid;
+    } else {
+      zeros += nodes_[nodes_[node].left].zeros;
+      node = nodes_[node].right;
+      lo = mid;
+    }
+  }
+  // Лист [lo, lo + 1) целиком левее pos, только если pos дошел до его правой границы
+  return pos >= hi ? zeros + nodes_[node].zeros : zeros;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+
+# Версии массива для поиска k-го нуля
+
+Персистентное дерево отрезков по количеству нулей для задачи A (подробное описание - в A.cpp).
+Каждое Update создает новую версию: копируется только путь от корня до измененного листа, остальные
+вершины общие с предыдущей версией, поэтому версия стоит O(log N) памяти. Версия 0 - исходный
+массив, версия t - массив после t обновлений. Индексы - с 1, как во входных данных.
+
+Вершины всех версий лежат в одном векторе и ссылаются друг на друга по номерам.
+
+*/
+
+class PersistentZeroTree {
+  struct Node {
+    uint32_t left;
+    uint32_t right;
+    uint32_t zeros;
+  };
+
+  uint32_t size_;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> roots_;
+
+public:
+  // source не должен быть пустым
+  explicit PersistentZeroTree(const std::vector<uint32_t>& source);
+
+  // Создает версию с элементом index, равным new_value, и возвращает ее номер. Если ноль не
+  // появился и не затерся, новая версия разделяет корень с предыдущей
+  uint32_t Update(uint32_t index, uint32_t new_value);
+
+  // Индекс k-того нуля на [left_bound, right_bound] в версии version или -1, в том числе для
+  // версии, которой еще нет (version >= Versions())
+  int32_t Search(uint32_t version, uint32_t left_bound, uint32_t right_bound, uint32_t k_value)
+      const;
+
+  uint32_t Versions() const {
+    return static_cast<uint32_t>(roots_.size());
+  }
+
+  size_t NodeCount() const {
+    return nodes_.size();
+  }
+
+  size_t MemoryBytes() const {
+    return nodes_.capacity() * sizeof(Node) + roots_.capacity() * sizeof(uint32_t);
+  }
+
+private:
+  // Строит поддерево по [lo, hi) и возвращает номер его корня
+  uint32_t Build(const std::vector<uint32_t>& source, uint32_t lo, uint32_t hi);
+
+  // Копия пути до листа idx с новым значением листа, возвращает номер нового корня поддерева
+  uint32_t Set(uint32_t node, uint32_t lo, uint32_t hi, uint32_t idx, uint32_t zero);
+
+  // Количество нулей среди элементов [0, pos) в дереве с корнем root
+  uint32_t ZerosBefore(uint32_t root, uint32_t pos) const;
+};
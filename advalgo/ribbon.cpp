@@ -0,0 +1,215 @@
+#include "advalgo/ribbon.hpp"
+
+#include <cctype>
+#include <cstdio>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <unistd.h>
+
+bool MatchesGreedy(std::string_view s, const std::vector<std::string>& words) {
+  size_t word_idx = 0;  // index of current word
+  const std::string* word = &words[word_idx];
+  size_t w_ptr = 0;  // pointer inside words[w]
+
+  for (size_t s_ptr = 0; s_ptr < s.length(); s_ptr++) {
+    if (s[s_ptr] == (*word)[w_ptr]) {
+      w_ptr++;
+
+      if (w_ptr == word->length()) {
+        word_idx++;
+
+        if (word_idx == words.size()) {
+          break;
+        }
+
+        word = &words[word_idx];
+        w_ptr = 0;
+
+        s_ptr++;
+      }
+    }
+  }
+
+  return word_idx == words.size() && w_ptr == words[words.size() - 1].length();
+}
+
+size_t FindByteScalar(const char* data, size_t size, size_t pos, char c) {
+  for (; pos < size; pos++) {
+    if (data[pos] == c) {
+      return pos;
+    }
+  }
+  return ByteNotFound;
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+size_t FindByteSse2(const char* data, size_t size, size_t pos, char c) {
+  const __m128i needle = _mm_set1_epi8(c);
+  for (; pos + 16 <= size; pos += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+    if (mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+  return FindByteScalar(data, size, pos, c);
+}
+
+__attribute__((target("avx2"))) size_t FindByteAvx2(
+    const char* data,
+    size_t size,
+    size_t pos,
+    char c
+) {
+  const __m256i needle = _mm256_set1_epi8(c);
+  // По 64 байта за итерацию: две маски по 32 бита склеиваются в одну 64-битную
+  for (; pos + 64 <= size; pos += 64) {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 32));
+    const auto lo_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    const auto hi_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    const uint64_t mask = lo_mask | (uint64_t{hi_mask} << 32);
+    if (mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+  return FindByteSse2(data, size, pos, c);
+}
+
+__attribute__((target("avx512bw"))) size_t FindByteAvx512(
+    const char* data,
+    size_t size,
+    size_t pos,
+    char c
+) {
+  const __m512i needle = _mm512_set1_epi8(c);
+  for (; pos + 64 <= size; pos += 64) {
+    const __m512i chunk = _mm512_loadu_si512(data + pos);
+    const uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, needle);
+    if (mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+  return FindByteSse2(data, size, pos, c);
+}
+
+#endif
+
+FindByteFn SelectFindByte() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  if (__builtin_cpu_supports("avx512bw")) {
+    return FindByteAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return FindByteAvx2;
+  }
+  return FindByteSse2;
+#else
+  return FindByteScalar;
+#endif
+}
+
+void RibbonIndex::Append(std::string_view chunk) {
+  for (const char ch : chunk) {
+    const size_t block = size_ >> 6;
+    if ((size_ & 63) == 0) {
+      for (auto& entries : entries_) {
+        entries.push_back({0, NoBlock});
+      }
+    }
+
+    const uint32_t c = Letter(ch);
+    auto& entries = entries_[c];
+    entries[block].mask |= uint64_t{1} << (size_ & 63);
+
+    // Все блоки с последнего заполненного до текущего ссылаются на текущий
+    for (size_t b = filled_[c]; b <= block; b++) {
+      entries[b].next_block = static_cast<uint32_t>(block);
+    }
+    filled_[c] = block + 1;
+
+    size_++;
+  }
+}
+
+size_t RibbonIndex::MemoryBytes() const {
+  size_t memory = 0;
+  for (const auto& entries : entries_) {
+    memory += entries.capacity() * sizeof(Entry);
+  }
+  return memory;
+}
+
+bool RibbonIndex::Matches(const std::vector<std::string>& words) const {
+  size_t pos = 0;
+  for (const auto& word : words) {
+    for (const char ch : word) {
+      pos = Next(ch, pos);
+      if (pos == NotFound) {
+        return false;
+      }
+      pos++;
+    }
+    pos++;  // между словами минимум одна буква
+  }
+  return true;
+}
+
+bool MemoryWords::Next(std::string_view& word) {
+  if (left_ == 0) {
+    return false;
+  }
+  while (pos_ < data_.size() && std::isspace(static_cast<unsigned char>(data_[pos_]))) {
+    pos_++;
+  }
+  const size_t begin = pos_;
+  while (pos_ < data_.size() && !std::isspace(static_cast<unsigned char>(data_[pos_]))) {
+    pos_++;
+  }
+  word = data_.substr(begin, pos_ - begin);
+  if (word.empty()) {
+    truncated_ = true;
+    return false;
+  }
+  left_--;
+  return true;
+}
+
+bool FileWords::Next(std::string_view& word) {
+  if (left_ == 0) {
+    return false;
+  }
+  word_.clear();
+  int ch = Get();
+  while (ch != EOF && std::isspace(ch)) {
+    ch = Get();
+  }
+  while (ch != EOF && !std::isspace(ch)) {
+    word_ += static_cast<char>(ch);
+    ch = Get();
+  }
+  word = word_;
+  if (word.empty()) {
+    truncated_ = true;
+    return false;
+  }
+  left_--;
+  return true;
+}
+
+int FileWords::Get() {
+  if (buffer_pos_ == buffer_size_) {
+    const ssize_t read = pread(fd_, buffer_.data(), BufferSize, offset_);
+    if (read <= 0) {
+      return EOF;
+    }
+    offset_ += read;
+    buffer_pos_ = 0;
+    buffer_size_ = static_cast<size_t>(read);
+  }
+  return static_cast<unsigned char>(buffer_[buffer_pos_++]);
+}
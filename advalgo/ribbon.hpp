@@ -0,0 +1,260 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+
+/*
+
+# Сопоставитель ленты
+
+Движки задачи F (подробное описание - в F.cpp): можно ли выбрать на ленте s слова t_1, ..., t_m
+как подпоследовательность с минимум одной буквой между соседними словами.
+- MatchesGreedy - исходные два указателя;
+- FindByte и MatchesScan - те же два указателя с векторным поиском следующей буквы;
+- RibbonIndex - индекс следующего вхождения для многих списков слов к одной ленте;
+- StreamMatcher - сопоставитель ленты, поступающей кусками, со словами из MemoryWords или FileWords.
+
+*/
+
+// Жадная проверка двумя указателями: первый итерируется по ленте, второй по словам
+bool MatchesGreedy(std::string_view s, const std::vector<std::string>& words);
+
+// Поиск первого вхождения байта c в data[pos, size). Векторные версии сравнивают сразу 16, 32
+// или 64 байта, собирают результат в битовую маску (movemask) и берут номер младшего бита (tzcnt)
+constexpr size_t ByteNotFound = std::string_view::npos;
+
+size_t FindByteScalar(const char* data, size_t size, size_t pos, char c);
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+size_t FindByteSse2(const char* data, size_t size, size_t pos, char c);
+
+__attribute__((target("avx2"))) size_t FindByteAvx2(
+    const char* data,
+    size_t size,
+    size_t pos,
+    char c
+);
+
+__attribute__((target("avx512bw"))) size_t FindByteAvx512(
+    const char* data,
+    size_t size,
+    size_t pos,
+    char c
+);
+
+#endif
+
+using FindByteFn = size_t (*)(const char*, size_t, size_t, char);
+
+// Лучшая версия для текущего процессора
+FindByteFn SelectFindByte();
+
+inline size_t FindByte(std::string_view s, size_t pos, char c) {
+  static const FindByteFn find = SelectFindByte();
+  return pos < s.size() ? find(s.data(), s.size(), pos, c) : ByteNotFound;
+}
+
+// Та же жадная проверка, что и MatchesGreedy, но буква слова ищется в ленте векторным поиском
+template <typename Find = decltype(&FindByte)>
+bool MatchesScan(std::string_view s, const std::vector<std::string>& words, Find find = FindByte) {
+  size_t pos = 0;
+  for (const auto& word : words) {
+    for (const char ch : word) {
+      pos = find(s, pos, ch);
+      if (pos == ByteNotFound) {
+        return false;
+      }
+      pos++;
+    }
+    pos++;  // между словами минимум одна буква
+  }
+  return true;
+}
+
+// Индекс следующего вхождения буквы в ленту. Лента разбита на блоки по 64 символа, для каждого
+// блока и буквы хранится маска вхождений и номер ближайшего блока с этой буквой
+class RibbonIndex {
+public:
+  static constexpr size_t NotFound = std::numeric_limits<size_t>::max();
+
+  RibbonIndex() {
+    filled_.fill(0);
+  }
+
+  static bool IsLetter(const char ch) {
+    return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z');
+  }
+
+  // Дописывает кусок ленты. Кусок должен состоять только из букв (IsLetter)
+  void Append(std::string_view chunk);
+
+  size_t Size() const {
+    return size_;
+  }
+
+  size_t MemoryBytes() const;
+
+  // Первая позиция не меньше pos с символом ch или NotFound. В ленте только буквы, поэтому
+  // остальные символы не находятся никогда
+  size_t Next(char ch, size_t pos) const {
+    if (pos >= size_ || !IsLetter(ch)) {
+      return NotFound;
+    }
+    const auto& entries = entries_[Letter(ch)];
+
+    const size_t block = pos >> 6;
+    const Entry& entry = entries[block];
+    const uint64_t mask = entry.mask & (~uint64_t{0} << (pos & 63));
+    if (mask != 0) {
+      return (block << 6) + std::countr_zero(mask);
+    }
+
+    // Ближайший блок с буквой не раньше текущего; если буква в текущем блоке была только левее
+    // pos, то следующий блок ищем от соседнего
+    uint32_t next = entry.next_block;
+    if (next == block) {
+      if ((block + 1) << 6 >= size_) {
+        return NotFound;
+      }
+      next = entries[block + 1].next_block;
+    }
+    if (next == NoBlock) {
+      return NotFound;
+    }
+    return (size_t{next} << 6) + std::countr_zero(entries[next].mask);
+  }
+
+  // Та же жадная проверка, что и MatchesGreedy, но прыжками по вхождениям букв
+  bool Matches(const std::vector<std::string>& words) const;
+
+private:
+  static constexpr uint32_t Alphabet = 52;
+  static constexpr uint32_t NoBlock = std::numeric_limits<uint32_t>::max();
+
+  // Маска и номер блока лежат рядом, чтобы поиск обычно обходился одним промахом кэша. Записи одной
+  // буквы хранятся подряд: поиски идут по возрастанию позиций и попадают в уже загруженные страницы
+  struct Entry {
+    uint64_t mask;
+    uint32_t next_block;
+  };
+
+  // 'A'..'Z' -> 0..25, 'a'..'z' -> 26..51
+  static uint32_t Letter(char ch) {
+    return ch <= 'Z' ? ch - 'A' : ch - 'a' + 26;
+  }
+
+  size_t size_ = 0;
+  std::array<std::vector<Entry>, Alphabet> entries_;
+  std::array<size_t, Alphabet> filled_;
+};
+
+// Жадный сопоставитель, получающий ленту кусками. Слова берутся из WordSource по одному: метод
+// Next(std::string_view&) возвращает false, когда слова кончились
+template <typename WordSource>
+class StreamMatcher {
+  WordSource& words_;
+  std::string_view word_;
+  size_t w_ptr_ = 0;
+  bool skip_ = false;  // первый символ следующего куска - промежуток между словами
+  bool done_ = false;  // все слова найдены
+
+public:
+  explicit StreamMatcher(WordSource& words) : words_(words) {
+    done_ = !words_.Next(word_);
+  }
+
+  // Возвращает true, когда все слова найдены и остаток ленты не нужен
+  bool Feed(std::string_view chunk) {
+    if (done_) {
+      return true;
+    }
+
+    size_t i = 0;
+    if (skip_ && !chunk.empty()) {
+      skip_ = false;
+      i = 1;
+    }
+
+    while ((i = FindByte(chunk, i, word_[w_ptr_])) != ByteNotFound) {
+      i++;
+      w_ptr_++;
+
+      if (w_ptr_ == word_.size()) {
+        if (!words_.Next(word_)) {
+          done_ = true;
+          return true;
+        }
+        w_ptr_ = 0;
+
+        // Пропускаем одну букву между словами, возможно, уже в следующем куске
+        if (i == chunk.size()) {
+          skip_ = true;
+          return false;
+        }
+        i++;
+      }
+    }
+    return false;
+  }
+
+  bool Done() const {
+    return done_;
+  }
+};
+
+// Слова, разделенные пробельными символами, прямо из памяти (например, из отображения файла).
+// Next возвращает false и после count слов, и если вход кончился раньше - тогда Truncated()
+class MemoryWords {
+  std::string_view data_;
+  size_t pos_ = 0;
+  size_t left_;
+  bool truncated_ = false;
+
+public:
+  MemoryWords(std::string_view data, size_t count) : data_(data), left_(count) {
+  }
+
+  bool Next(std::string_view& word);
+
+  bool Truncated() const {
+    return truncated_;
+  }
+};
+
+// Слова из файла, читаемые через pread собственным буфером. В памяти только буфер и текущее слово.
+// Короткий список слов - так же, как в MemoryWords
+class FileWords {
+  static constexpr size_t BufferSize = 1 << 16;
+
+  int fd_;
+  off_t offset_;
+  size_t left_;
+  std::string buffer_;
+  size_t buffer_pos_ = 0;
+  size_t buffer_size_ = 0;
+  std::string word_;
+  bool truncated_ = false;
+
+public:
+  FileWords(int fd, off_t offset, size_t count)
+      : fd_(fd), offset_(offset), left_(count), buffer_(BufferSize, '\0') {
+  }
+
+  bool Next(std::string_view& word);
+
+  bool Truncated() const {
+    return truncated_;
+  }
+
+private:
+  int Get();
+};
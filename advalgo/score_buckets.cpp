@@ -0,0 +1,85 @@
+#include "advalgo/score_buckets.hpp"
+
+#include <bit>
+
+#include "advalgo/bits.hpp"
+
+namespace youndex::express {
+
+ScoreBuckets::ScoreBuckets(
+    const uint32_t buckets,
+    const std::vector<std::pair<uint32_t, uint32_t>>& nonempty
+) {
+  for (const auto& bucket : nonempty) {
+    size_ += bucket.second;
+  }
+
+  // Вектор заполняется нулями, потом в нем выставляются единицы элементов непустых корзин. Биты
+  // после конца вектора - единицы, чтобы select0 их не находил
+  const size_t length = size_ + buckets;
+  const size_t superblocks = (length + SuperblockBits - 1) / SuperblockBits;
+  words_ = std::vector<uint64_t>(superblocks * WordsPerSuperblock, 0);
+  auto set_ones = [this](size_t from, const size_t to) {
+    for (; from < to && (from & 63) != 0; from++) {
+      words_[from >> 6] |= uint64_t{1} << (from & 63);
+    }
+    for (; from + 64 <= to; from += 64) {
+      words_[from >> 6] = ~uint64_t{0};
+    }
+    for (; from < to; from++) {
+      words_[from >> 6] |= uint64_t{1} << (from & 63);
+    }
+  };
+  set_ones(length, words_.size() * 64);
+
+  // Ноль корзины b стоит на позиции b + количество элементов в корзинах до b включительно
+  size_t before = 0;
+  auto next = nonempty.begin();
+  for (uint32_t sample = 0; sample < buckets; sample += SampleRate) {
+    for (; next != nonempty.end() && next->first <= sample; ++next) {
+      set_ones(next->first + before, next->first + before + next->second);
+      before += next->second;
+    }
+    samples_.push_back(static_cast<uint32_t>((sample + before) / SuperblockBits));
+  }
+  for (; next != nonempty.end(); ++next) {
+    set_ones(next->first + before, next->first + before + next->second);
+    before += next->second;
+  }
+
+  ones_before_.resize(superblocks);
+  uint32_t ones = 0;
+  for (size_t superblock = 0; superblock < superblocks; superblock++) {
+    ones_before_[superblock] = ones;
+    for (size_t word = 0; word < WordsPerSuperblock; word++) {
+      ones += std::popcount(words_[superblock * WordsPerSuperblock + word]);
+    }
+  }
+}
+
+POPCNT_CLONES size_t ScoreBuckets::SelectZero(const uint32_t rank) const {
+  // Последний суперблок, до которого меньше rank + 1 нулей, лежит между соседними сэмплами
+  size_t lo = samples_[rank / SampleRate];
+  size_t hi = rank / SampleRate + 1 < samples_.size() ? samples_[rank / SampleRate + 1]
+                                                      : ones_before_.size() - 1;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo + 1) / 2;
+    if (ZerosBefore(mid) <= rank) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  auto left = static_cast<uint32_t>(rank - ZerosBefore(lo));
+  for (size_t word = lo * WordsPerSuperblock;; word++) {
+    const uint64_t zeros = ~words_[word];
+    const auto count = static_cast<uint32_t>(std::popcount(zeros));
+    if (left < count) {
+      return (word << 6) + SelectBit(zeros, left);
+    }
+    left -= count;
+  }
+}
+
+}  // namespace youndex::express
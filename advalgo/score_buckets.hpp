@@ -0,0 +1,84 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+
+# Границы корзин рейтингов
+
+Сжатый индекс начала и конца каждой корзины в массиве, отсортированном по корзинам (в ленте товаров
+C корзина - рейтинг, их 65536). Корзины записаны в битовый вектор в унарном виде: для каждой
+корзины по единице на элемент, затем ноль. Конец корзины b - это количество единиц до нуля с номером
+b, то есть select0(b) - b.
+
+select0 работает за O(log) без прохода по корзинам: каждые 512 бит (суперблок) хранится количество
+единиц до него, а для каждого 512-го нуля - суперблок, в котором он лежит. Нужный суперблок ищется
+двоичным поиском между двумя соседними сэмплами (даже если все элементы в одной корзине), внутри
+суперблока - popcount по словам. Память - (N + B) бит плюс около 6% на суперблоки.
+
+Построение и проход по элементам (ForEach) не перебирают корзины по одной: пустые корзины - это
+нулевые слова вектора, поэтому оба стоят O(N + B / 64 + непустых корзин).
+
+*/
+
+namespace youndex::express {
+
+class ScoreBuckets {
+  static constexpr size_t WordsPerSuperblock = 8;
+  static constexpr size_t SuperblockBits = 64 * WordsPerSuperblock;
+  static constexpr size_t SampleRate = 512;  // сэмпл на каждый SampleRate-ый ноль
+
+  std::vector<uint64_t> words_;
+  std::vector<uint32_t> ones_before_;  // единиц до начала суперблока
+  std::vector<uint32_t> samples_;      // суперблок нуля с номером t * SampleRate
+  size_t size_ = 0;                    // количество элементов
+
+public:
+  ScoreBuckets() = default;
+
+  // buckets - количество корзин, nonempty - пары (корзина, количество элементов) непустых корзин
+  // по возрастанию корзины
+  ScoreBuckets(uint32_t buckets, const std::vector<std::pair<uint32_t, uint32_t>>& nonempty);
+
+  // Элементы корзины bucket занимают [Begin(bucket), End(bucket)) массива
+  size_t Begin(const uint32_t bucket) const {
+    return bucket == 0 ? 0 : End(bucket - 1);
+  }
+
+  size_t End(const uint32_t bucket) const {
+    return SelectZero(bucket) - bucket;
+  }
+
+  // Вызывает visit(position, bucket) для каждого элемента массива по порядку
+  template <typename Visit>
+  void ForEach(Visit visit) const {
+    size_t position = 0;
+    for (size_t word = 0; word < words_.size(); word++) {
+      // Единицы за концом вектора не элементы: их позиция не меньше общего числа элементов
+      for (uint64_t bits = words_[word]; bits != 0 && position < size_; bits &= bits - 1) {
+        const size_t bit = (word << 6) + std::countr_zero(bits);
+        visit(position, static_cast<uint32_t>(bit - position));
+        position++;
+      }
+    }
+  }
+
+  size_t MemoryBytes() const {
+    return words_.capacity() * sizeof(uint64_t) +
+           (ones_before_.capacity() + samples_.capacity()) * sizeof(uint32_t);
+  }
+
+private:
+  // Позиция нуля с номером rank (с 0)
+  size_t SelectZero(uint32_t rank) const;
+
+  size_t ZerosBefore(const size_t superblock) const {
+    return superblock * SuperblockBits - ones_before_[superblock];
+  }
+};
+
+}  // namespace youndex::express
@@ -0,0 +1,291 @@
+#include "advalgo/segmented_array.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "advalgo/bits.hpp"
+
+NarrowValues::NarrowValues(const std::vector<uint32_t>& source) {
+  const uint32_t max = source.empty() ? 0 : *std::max_element(source.begin(), source.end());
+  width_ = WidthFor(max);
+  bytes_.resize(source.size() * width_);
+  for (size_t i = 0; i < source.size(); i++) {
+    Set(i, source[i]);
+  }
+}
+
+void NarrowValues::Set(const size_t idx, const uint32_t value) {
+  if (WidthFor(value) > width_) {
+    Widen(WidthFor(value));
+  }
+  uint8_t* ptr = bytes_.data() + idx * width_;
+  for (uint32_t byte = 0; byte < width_; byte++) {
+    ptr[byte] = static_cast<uint8_t>(value >> (8 * byte));
+  }
+}
+
+void NarrowValues::Fill(const size_t first, const size_t count, const uint32_t value) {
+  for (size_t i = first; i < first + count; i++) {
+    Set(i, value);
+  }
+}
+
+void NarrowValues::Widen(const uint32_t width) {
+  NarrowValues wider;
+  wider.width_ = width;
+  wider.bytes_.resize(bytes_.size() / width_ * width);
+  for (size_t i = 0; i < bytes_.size() / width_; i++) {
+    wider.Set(i, Get(i));
+  }
+  *this = std::move(wider);
+}
+
+SegmentedArray::SegmentedArray(const std::vector<uint32_t>& source, const bool keep_values)
+    : block_size_(static_cast<uint32_t>(1) << BlockSizeShift),
+      size_(source.size()),
+      keep_values_(keep_values) {
+  uint32_t blocks_count = size_ >> BlockSizeShift;
+  if ((size_ & (block_size_ - 1)) > 0) {
+    blocks_count++;
+  }
+
+  zero_bits_ = std::vector<uint64_t>(size_t{blocks_count} * WordsPerBlock, 0);
+  zeros_ = std::vector<uint16_t>(blocks_count, 0);
+  nonempty_ = std::vector<uint64_t>((blocks_count + 63) / 64, 0);
+
+  for (uint32_t i = 0; i < size_; i++) {
+    if (source[i] == 0) {
+      zero_bits_[i >> 6] |= uint64_t{1} << (i & 63);
+      zeros_[BlockOfElement(i)]++;
+    }
+  }
+  for (uint32_t block = 0; block < blocks_count; block++) {
+    MarkBlock(block);
+  }
+
+  if (keep_values_) {
+    values_ = NarrowValues(source);
+    uniform_ = std::vector<uint8_t>(blocks_count, 0);
+    tag_ = std::vector<uint32_t>(blocks_count, 0);
+  }
+}
+
+void SegmentedArray::Update(const uint32_t index, const uint32_t new_value) {
+  const uint32_t idx = index - 1;
+
+  if (keep_values_) {
+    Push(BlockOfElement(idx));
+    values_.Set(idx, new_value);
+  }
+
+  const uint64_t bit = uint64_t{1} << (idx & 63);
+  const bool was_zero = (zero_bits_[idx >> 6] & bit) != 0;
+
+  // Если ноль не появился и не затерся, то обновлять ничего не нужно
+  if (was_zero == (new_value == 0)) {
+    return;
+  }
+
+  zero_bits_[idx >> 6] ^= bit;
+  if (was_zero) {
+    zeros_[BlockOfElement(idx)]--;
+  } else {
+    zeros_[BlockOfElement(idx)]++;
+  }
+  MarkBlock(BlockOfElement(idx));
+}
+
+void SegmentedArray::AssignRange(
+    const uint32_t left_bound,
+    const uint32_t right_bound,
+    const uint32_t value
+) {
+  if (left_bound > right_bound) {
+    return;
+  }
+
+  const uint32_t left = left_bound - 1;
+  const uint32_t right = right_bound - 1;
+
+  const uint32_t left_block = BlockOfElement(left);
+  const uint32_t right_block = BlockOfElement(right);
+  const bool zero = value == 0;
+
+  // Блоки [full_begin, full_end) лежат в отрезке целиком и имеют полную длину: их маска и счетчики
+  // заполняются подряд. Остальные - граничные и последний неполный - через AssignBits
+  const uint32_t full_begin = left == FirstIndexOfBlock(left_block) ? left_block : left_block + 1;
+  const uint32_t full_end =
+      std::max(full_begin, std::min(BlockOfElement(right + 1), size_ >> BlockSizeShift));
+
+  std::fill(
+      zero_bits_.begin() + size_t{full_begin} * WordsPerBlock,
+      zero_bits_.begin() + size_t{full_end} * WordsPerBlock,
+      zero ? ~uint64_t{0} : 0
+  );
+  std::fill(zeros_.begin() + full_begin, zeros_.begin() + full_end, zero ? block_size_ : 0);
+  FillNonempty(full_begin, full_end, zero);
+
+  auto assign_part = [&](const uint32_t block) {
+    const uint32_t first = FirstIndexOfBlock(block);
+    AssignBits(std::max(first, left), std::min(first + BlockLength(block) - 1, right), zero);
+  };
+  for (uint32_t block = left_block; block < full_begin; block++) {
+    assign_part(block);
+  }
+  for (uint32_t block = full_end; block <= right_block; block++) {
+    assign_part(block);
+  }
+
+  if (!keep_values_) {
+    return;
+  }
+
+  for (uint32_t block = left_block; block <= right_block; block++) {
+    const uint32_t first = FirstIndexOfBlock(block);
+    const uint32_t last = first + BlockLength(block) - 1;
+    const uint32_t from = std::max(first, left);
+    const uint32_t to = std::min(last, right);
+
+    // Блок целиком внутри отрезка: помечаем его однородным, значения не трогаем
+    if (from == first && to == last) {
+      uniform_[block] = 1;
+      tag_[block] = value;
+      continue;
+    }
+
+    // Блок на границе отрезка: присваиваем честно по одному элементу
+    Push(block);
+    values_.Fill(from, to - from + 1, value);
+  }
+}
+
+int32_t SegmentedArray::Search(
+    const uint32_t left_bound,
+    const uint32_t right_bound,
+    const uint32_t k_value
+) const {
+  if (left_bound > right_bound) {
+    return -1;
+  }
+
+  const uint32_t left = left_bound - 1;
+  const uint32_t right = right_bound - 1;
+
+  const uint32_t left_block = BlockOfElement(left);
+  const uint32_t right_block = BlockOfElement(right);
+
+  uint32_t zeros_count = 0;
+
+  // Если границы попали на один блок, то считаем честно по маске
+  if (left_block == right_block) {
+    return ScanPart(left, right, k_value, zeros_count);
+  }
+
+  uint32_t i_block = left_block;
+
+  // Считаем 0 в правой части блока, в который попала левая граница
+  if (FirstIndexOfBlock(left_block) != left) {
+    const uint32_t last = FirstIndexOfBlock(left_block + 1) - 1;
+    const int32_t found = ScanPart(left, last, k_value, zeros_count);
+    if (found != -1) {
+      return found;
+    }
+    i_block++;
+  }
+
+  // Считаем 0 в блоках между блоками, в которые попали левая и правая границы
+  while (i_block < right_block) {
+    // Если в промежуточном блоке нашли нужный k-тый 0
+    if (zeros_count + zeros_[i_block] >= k_value) {
+      const uint32_t last = FirstIndexOfBlock(i_block) + BlockLength(i_block) - 1;
+      return ScanPart(FirstIndexOfBlock(i_block), last, k_value, zeros_count);
+    }
+
+    zeros_count += zeros_[i_block];
+    i_block++;
+  }
+
+  // Честно считаем по маске блока, в который попала правая граница. Если нужного k-того 0 на
+  // промежутке нет, то вернется -1
+  return ScanPart(FirstIndexOfBlock(right_block), right, k_value, zeros_count);
+}
+
+POPCNT_CLONES int32_t SegmentedArray::ScanPart(
+    const uint32_t from,
+    const uint32_t to,
+    const uint32_t k_value,
+    uint32_t& zeros_count
+) const {
+  for (uint32_t word = from >> 6; word <= to >> 6; word++) {
+    // Оставляем в слове только биты элементов из [from, to]
+    uint64_t bits = zero_bits_[word];
+    if (word == from >> 6) {
+      bits &= ~uint64_t{0} << (from & 63);
+    }
+    if (word == to >> 6) {
+      bits &= ~uint64_t{0} >> (63 - (to & 63));
+    }
+
+    const auto count = static_cast<uint32_t>(std::popcount(bits));
+    if (zeros_count + count < k_value) {
+      zeros_count += count;
+      continue;
+    }
+
+    // Нужный ноль в этом слове
+    const uint32_t bit = SelectBit(bits, k_value - zeros_count - 1);
+    zeros_count = k_value;
+    return static_cast<int32_t>((word << 6) + bit + 1);
+  }
+  return -1;
+}
+
+void SegmentedArray::AssignBits(const uint32_t from, const uint32_t to, const bool zero) {
+  for (uint32_t word = from >> 6; word <= to >> 6; word++) {
+    uint64_t mask = ~uint64_t{0};
+    if (word == from >> 6) {
+      mask &= ~uint64_t{0} << (from & 63);
+    }
+    if (word == to >> 6) {
+      mask &= ~uint64_t{0} >> (63 - (to & 63));
+    }
+    zero_bits_[word] = zero ? zero_bits_[word] | mask : zero_bits_[word] & ~mask;
+  }
+
+  // Блок целиком: нули считаются без popcount
+  const uint32_t block = BlockOfElement(from);
+  if (from == FirstIndexOfBlock(block) && to - from + 1 == BlockLength(block)) {
+    zeros_[block] = zero ? BlockLength(block) : 0;
+  } else {
+    zeros_[block] = CountBlockZeros(block);
+  }
+  MarkBlock(block);
+}
+
+POPCNT_CLONES uint16_t SegmentedArray::CountBlockZeros(const uint32_t block) const {
+  uint32_t zeros = 0;
+  for (uint32_t word = 0; word < WordsPerBlock; word++) {
+    zeros += std::popcount(zero_bits_[block * WordsPerBlock + word]);
+  }
+  return static_cast<uint16_t>(zeros);
+}
+
+void SegmentedArray::FillNonempty(const uint32_t begin, const uint32_t end, const bool nonempty) {
+  for (uint32_t block = begin; block < end;) {
+    // Биты [block, end) текущего слова маски
+    const uint32_t word = block >> 6;
+    const uint32_t count = std::min(64 - (block & 63), end - block);
+    const uint64_t mask = (count == 64 ? ~uint64_t{0} : (uint64_t{1} << count) - 1) << (block & 63);
+    nonempty_[word] = nonempty ? nonempty_[word] | mask : nonempty_[word] & ~mask;
+    block += count;
+  }
+}
+
+void SegmentedArray::Push(const uint32_t block) {
+  if (uniform_[block] == 0) {
+    return;
+  }
+  values_.Fill(FirstIndexOfBlock(block), BlockLength(block), tag_[block]);
+  uniform_[block] = 0;
+}
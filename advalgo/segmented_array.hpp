@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+
+# Массив с блоками
+
+Движок задачи A (подробное описание - в A.cpp): массив, разбитый на блоки по 2^BlockSizeShift
+элементов со счетчиком нулей в каждом блоке. Индексы - с 1, как во входных данных.
+
+Поиску нужно знать про элемент только то, ноль ли он, поэтому массив хранится битовой маской нулей:
+бит на элемент вместо 32, блок из 128 элементов - два слова по 64 бита. Внутри блока k-тый ноль
+ищется по словам через popcount, а нужный бит - через tzcnt.
+
+Сами значения хранятся, только если их попросили при создании (keep_values), в NarrowValues. В
+этом случае присваивание на отрезке ленивое: блок, целиком попавший в отрезок, помечается
+однородным (все его элементы равны tag_), а значения записываются только перед изменением
+отдельных элементов блока (Push). Маска нулей обновляется сразу - это два слова на блок.
+
+Для маленького k, известного при компиляции (первый или второй свободный элемент), есть
+FindKthZero<K> и FindFirstZero. Они не считают popcount: блоки без нулей пропускаются по битовой
+маске непустых блоков (nonempty_, бит на блок) через tzcnt, а в слове с нулями снимается не больше
+K младших единиц.
+
+*/
+
+constexpr uint32_t BlockSizeShift = 7;  // размер блока равен 2^BlockSizeShift
+
+// Значения шириной от 1 до 4 байт. Ширина выбирается по наибольшему значению и увеличивается,
+// когда записывается значение, которое в нее не помещается
+class NarrowValues {
+  std::vector<uint8_t> bytes_;
+  uint32_t width_ = 1;
+
+public:
+  NarrowValues() = default;
+
+  explicit NarrowValues(const std::vector<uint32_t>& source);
+
+  uint32_t Get(size_t idx) const {
+    const uint8_t* ptr = bytes_.data() + idx * width_;
+    switch (width_) {
+      case 1:
+        return ptr[0];
+      case 2:
+        return ptr[0] | uint32_t{ptr[1]} << 8;
+      case 3:
+        return ptr[0] | uint32_t{ptr[1]} << 8 | uint32_t{ptr[2]} << 16;
+      default:
+        return ptr[0] | uint32_t{ptr[1]} << 8 | uint32_t{ptr[2]} << 16 | uint32_t{ptr[3]} << 24;
+    }
+  }
+
+  void Set(size_t idx, uint32_t value);
+
+  void Fill(size_t first, size_t count, uint32_t value);
+
+  size_t MemoryBytes() const {
+    return bytes_.capacity();
+  }
+
+private:
+  static uint32_t WidthFor(const uint32_t value) {
+    return value <= 0xFF ? 1 : value <= 0xFFFF ? 2 : value <= 0xFFFFFF ? 3 : 4;
+  }
+
+  void Widen(uint32_t width);
+};
+
+class SegmentedArray {
+  static constexpr uint32_t WordsPerBlock = 1 << (BlockSizeShift - 6);
+  static_assert(BlockSizeShift >= 6, "block must consist of whole 64-bit words");
+
+  uint32_t block_size_;
+  uint32_t size_;
+  bool keep_values_;
+  std::vector<uint64_t> zero_bits_;  // бит i равен 1, если элемент i - ноль
+  std::vector<uint16_t> zeros_;
+  std::vector<uint64_t> nonempty_;  // бит b равен 1, если в блоке b есть ноль
+
+  // Только при keep_values
+  NarrowValues values_;
+  std::vector<uint8_t> uniform_;  // 1, если все элементы блока равны tag_[block]
+  std::vector<uint32_t> tag_;
+
+public:
+  explicit SegmentedArray(const std::vector<uint32_t>& source, bool keep_values = false);
+
+  void Update(uint32_t index, uint32_t new_value);
+
+  // Присваивает value всем элементам [left_bound, right_bound] за O(BLOCK_SIZE + BLOCKS_COUNT)
+  void AssignRange(uint32_t left_bound, uint32_t right_bound, uint32_t value);
+
+  int32_t Search(uint32_t left_bound, uint32_t right_bound, uint32_t k_value) const;
+
+  // То же, что Search(left_bound, right_bound, K), для небольшого K, известного при компиляции
+  template <uint32_t K>
+  int32_t FindKthZero(uint32_t left_bound, uint32_t right_bound) const;
+
+  int32_t FindFirstZero(const uint32_t left_bound, const uint32_t right_bound) const {
+    return FindKthZero<1>(left_bound, right_bound);
+  }
+
+  bool KeepsValues() const {
+    return keep_values_;
+  }
+
+  // Значение элемента, только для массива, созданного с keep_values
+  uint32_t Value(const uint32_t index) const {
+    const uint32_t idx = index - 1;
+    const uint32_t block = BlockOfElement(idx);
+    return uniform_[block] != 0 ? tag_[block] : values_.Get(idx);
+  }
+
+  size_t MemoryBytes() const {
+    return zero_bits_.capacity() * sizeof(uint64_t) + zeros_.capacity() * sizeof(uint16_t) +
+           nonempty_.capacity() * sizeof(uint64_t) + values_.MemoryBytes() + uniform_.capacity() +
+           tag_.capacity() * sizeof(uint32_t);
+  }
+
+private:
+  static uint32_t BlockOfElement(const uint32_t index) {
+    return index >> BlockSizeShift;
+  }
+
+  static uint32_t FirstIndexOfBlock(const uint32_t block) {
+    return block << BlockSizeShift;
+  }
+
+  // Последний блок может быть неполным
+  uint32_t BlockLength(const uint32_t block) const {
+    return std::min<uint32_t>(block_size_, size_ - FirstIndexOfBlock(block));
+  }
+
+  // Ищет k-тый 0 среди [from, to] внутри одного блока с учетом уже найденных zeros_count нулей.
+  // Возвращает индекс с 1 или -1, тогда к zeros_count прибавляются нули части блока
+  int32_t ScanPart(uint32_t from, uint32_t to, uint32_t k_value, uint32_t& zeros_count) const;
+
+  // Записывает нулевой бит элементов [from, to] одного блока и пересчитывает нули блока
+  void AssignBits(uint32_t from, uint32_t to, bool zero);
+
+  uint16_t CountBlockZeros(uint32_t block) const;
+
+  // Записывает в nonempty_, есть ли в блоке нули, по zeros_[block]
+  void MarkBlock(const uint32_t block) {
+    const uint64_t bit = uint64_t{1} << (block & 63);
+    nonempty_[block >> 6] = zeros_[block] > 0 ? nonempty_[block >> 6] | bit
+                                              : nonempty_[block >> 6] & ~bit;
+  }
+
+  // Записывает в nonempty_ одно значение для блоков [begin, end)
+  void FillNonempty(uint32_t begin, uint32_t end, bool nonempty);
+
+  // Первый блок с нулями среди [block, last_block] или -1
+  int64_t NextNonemptyBlock(const uint32_t block, const uint32_t last_block) const {
+    uint32_t word = block >> 6;
+    uint64_t bits = nonempty_[word] & (~uint64_t{0} << (block & 63));
+    while (bits == 0) {
+      if (++word > last_block >> 6) {
+        return -1;
+      }
+      bits = nonempty_[word];
+    }
+    const uint32_t found = (word << 6) + std::countr_zero(bits);
+    return found <= last_block ? found : -1;
+  }
+
+  // Ищет в слове bits ноль с номером need (с 1), need не больше K. Снимает не больше K младших
+  // единиц. Возвращает номер бита или -1, тогда из need вычитаются нули слова
+  template <uint32_t K>
+  static int32_t TakeZeros(uint64_t bits, uint32_t& need) {
+    for (uint32_t i = 0; i < K && bits != 0; i++) {
+      if (need == 1) {
+        return std::countr_zero(bits);
+      }
+      bits &= bits - 1;
+      need--;
+    }
+    return -1;
+  }
+
+  // Записывает значение однородного блока в values_ и снимает пометку
+  void Push(uint32_t block);
+};
+
+template <uint32_t K>
+int32_t SegmentedArray::FindKthZero(const uint32_t left_bound, const uint32_t right_bound) const {
+  static_assert(K >= 1 && K <= 8, "FindKthZero is meant for small K, use Search otherwise");
+
+  if (left_bound > right_bound) {
+    return -1;
+  }
+
+  const uint32_t right = right_bound - 1;
+  const uint32_t right_block = BlockOfElement(right);
+  uint32_t need = K;
+
+  for (uint32_t pos = left_bound - 1; pos <= right;) {
+    const int64_t block = NextNonemptyBlock(BlockOfElement(pos), right_block);
+    if (block == -1) {
+      return -1;
+    }
+
+    const uint32_t first = FirstIndexOfBlock(static_cast<uint32_t>(block));
+    const uint32_t from = std::max(pos, first);
+    const uint32_t to = std::min(first + block_size_ - 1, right);
+    pos = to + 1;
+
+    // Блок целиком в отрезке, и нужного нуля в нем нет - хватает счетчика
+    if constexpr (K > 1) {
+      if (from == first && to - from + 1 == block_size_ && zeros_[block] < need) {
+        need -= zeros_[block];
+        continue;
+      }
+    }
+
+    for (uint32_t word = from >> 6; word <= to >> 6; word++) {
+      uint64_t bits = zero_bits_[word];
+      if (word == from >> 6) {
+        bits &= ~uint64_t{0} << (from & 63);
+      }
+      if (word == to >> 6) {
+        bits &= ~uint64_t{0} >> (63 - (to & 63));
+      }
+
+      const int32_t bit = TakeZeros<K>(bits, need);
+      if (bit != -1) {
+        return static_cast<int32_t>((word << 6) + bit + 1);
+      }
+    }
+  }
+  return -1;
+}
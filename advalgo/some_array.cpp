@@ -0,0 +1,14 @@
+#include "advalgo/some_array.hpp"
+
+SomeArray::SomeArray([[maybe_unused]] const std::vector<int32_t>& source) {
+  // TODO: implement
+}
+
+void SomeArray::Swap([[maybe_unused]] size_t x, [[maybe_unused]] size_t y) {
+  // TODO: implement
+}
+
+int64_t SomeArray::CalculateSum([[maybe_unused]] size_t a, [[maybe_unused]] size_t b) {
+  // TODO: implement
+  return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+
+# Массив с обменом пар
+
+Движок задачи D (условие - в D.cpp): обмен соседних пар на отрезке четной длины и сумма на отрезке.
+
+*/
+
+class SomeArray {
+public:
+  explicit SomeArray(const std::vector<int32_t>& source);
+  void Swap(size_t x, size_t y);
+  int64_t CalculateSum(size_t a, size_t b);
+
+private:
+  struct Node {
+    int64_t value;
+    int64_t sum;
+    size_t size;
+    uint16_t score;
+    Node *left, *right;
+    Node(int64_t v = 0, uint16_t p = 0)
+        : value(v), sum(v), size(1), score(p), left(nullptr), right(nullptr) {
+    }
+  };
+};
@@ -0,0 +1,43 @@
+#include "advalgo/square.hpp"
+
+#include <cstring>
+
+bool IsSquareByChars(std::string_view line) {
+  const size_t size = line.size();
+
+  if ((size & 0x1) > 0) {
+    return false;
+  }
+
+  const size_t half = size >> 1;
+  for (size_t i = 0; i < half; i++) {
+    if (line[i] != line[half + i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsSquare(std::string_view line) {
+  const size_t size = line.size();
+
+  if ((size & 0x1) > 0) {
+    return false;
+  }
+
+  const size_t half = size >> 1;
+  return std::memcmp(line.data(), line.data() + half, half) == 0;
+}
+
+SquareIndex::SquareIndex(std::string_view s, uint64_t seed)
+    : prefix_(s.size() + 1, 0), power_(s.size() + 1, 1) {
+  // Случайное основание, чтобы коллизии нельзя было подобрать заранее
+  base_ = std::mt19937_64(seed)() % (Mod - 256) + 256;
+  for (size_t i = 0; i < s.size(); i++) {
+    prefix_[i + 1] = MulMod(prefix_[i], base_) + static_cast<unsigned char>(s[i]);
+    if (prefix_[i + 1] >= Mod) {
+      prefix_[i + 1] -= Mod;
+    }
+    power_[i + 1] = MulMod(power_[i], base_);
+  }
+}
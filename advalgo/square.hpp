@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+/*
+
+# Квадратные строки
+
+Движки задачи 0 (подробное описание - в 0.cpp): проверка, что строка состоит из двух одинаковых
+половин, и индекс префиксных хешей для запросов к подстрокам одной строки.
+
+*/
+
+// Исходная проверка: посимвольное сравнение половин
+bool IsSquareByChars(std::string_view line);
+
+// Сравнение половин через memcmp
+bool IsSquare(std::string_view line);
+
+// Префиксные полиномиальные хеши по модулю 2^61 - 1: хеш любой подстроки за O(1)
+class SquareIndex {
+  static constexpr uint64_t Mod = (uint64_t{1} << 61) - 1;
+
+  uint64_t base_;
+  std::vector<uint64_t> prefix_;  // prefix_[i] - хеш s[0, i)
+  std::vector<uint64_t> power_;   // power_[i] = base_^i
+
+  static uint64_t MulMod(uint64_t a, uint64_t b) {
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    const uint64_t value =
+        (static_cast<uint64_t>(product) & Mod) + static_cast<uint64_t>(product >> 61);
+    return value >= Mod ? value - Mod : value;
+  }
+
+  // Хеш s[l, r)
+  uint64_t Hash(size_t l, size_t r) const {
+    const uint64_t shifted = MulMod(prefix_[l], power_[r - l]);
+    return prefix_[r] >= shifted ? prefix_[r] - shifted : prefix_[r] + Mod - shifted;
+  }
+
+public:
+  explicit SquareIndex(std::string_view s, uint64_t seed = std::random_device{}());
+
+  size_t Size() const {
+    return prefix_.size() - 1;
+  }
+
+  size_t MemoryBytes() const {
+    return (prefix_.capacity() + power_.capacity()) * sizeof(uint64_t);
+  }
+
+  // Подтягивает в кеш хеши, нужные для IsSquare(l, r)
+  void Prefetch(size_t l, size_t r) const {
+    if (l < r && r <= Size()) {
+      __builtin_prefetch(&prefix_[l]);
+      __builtin_prefetch(&prefix_[l + ((r - l) >> 1)]);
+      __builtin_prefetch(&prefix_[r]);
+      __builtin_prefetch(&power_[(r - l) >> 1]);
+    }
+  }
+
+  // Является ли квадратом подстрока s[l, r)
+  bool IsSquare(size_t l, size_t r) const {
+    if (l >= r || r > Size() || ((r - l) & 0x1) > 0) {
+      return false;
+    }
+    const size_t mid = l + ((r - l) >> 1);
+    return Hash(l, mid) == Hash(mid, r);
+  }
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+
+# Обход дерева
+
+Общий модуль для задач E и H. Дерево хранится в виде списков смежности, упакованных в плоские
+массивы (CSR): соседи вершины v лежат подряд в targets_[offsets_[v], offsets_[v + 1]), а веса
+ребер - в weights_ по тем же индексам. Вместо вектора векторов - два выделения памяти на все дерево.
+
+Поскольку граф - дерево, при обходе не нужно множество посещенных вершин: достаточно не возвращаться
+в родителя. Очередь BFS и стек DFS - заранее выделенные массивы размера n без промежуточных
+аллокаций. Обход возвращает порядок вершин (каждая вершина идет после своего родителя), родителя,
+глубину и xor весов ребер на пути от корня. Порядок переиспользуется последующими проходами
+(например, заполнением таблицы двоичного подъема) как обычный линейный проход по массиву.
+
+## Асимптотика
+Время: O(n) на построение и на обход
+Память: O(n)
+
+*/
+
+struct Edge {
+  int32_t u;
+  int32_t v;
+  int32_t w = 0;
+};
+
+class Tree {
+  std::vector<uint32_t> offsets_;
+  std::vector<int32_t> targets_;
+  std::vector<int32_t> weights_;
+
+public:
+  // Вершины нумеруются от 0 до n - 1, ребра неориентированные
+  Tree(int32_t n, const std::vector<Edge>& edges)
+      : offsets_(n + 1, 0), targets_(2 * edges.size()), weights_(2 * edges.size()) {
+    for (const Edge& e : edges) {
+      offsets_[e.u + 1]++;
+      offsets_[e.v + 1]++;
+    }
+    for (int32_t v = 0; v < n; v++) {
+      offsets_[v + 1] += offsets_[v];
+    }
+
+    std::vector<uint32_t> pos(offsets_.begin(), offsets_.end() - 1);
+    for (const Edge& e : edges) {
+      targets_[pos[e.u]] = e.v;
+      weights_[pos[e.u]++] = e.w;
+      targets_[pos[e.v]] = e.u;
+      weights_[pos[e.v]++] = e.w;
+    }
+  }
+
+  int32_t Size() const {
+    return static_cast<int32_t>(offsets_.size()) - 1;
+  }
+
+  std::span<const int32_t> Neighbors(int32_t v) const {
+    return {targets_.data() + offsets_[v], targets_.data() + offsets_[v + 1]};
+  }
+
+  std::span<const int32_t> Weights(int32_t v) const {
+    return {weights_.data() + offsets_[v], weights_.data() + offsets_[v + 1]};
+  }
+};
+
+struct Traversal {
+  std::vector<int32_t> order;       // вершины в порядке обхода, каждая после своего родителя
+  std::vector<int32_t> parent;      // -1 для корня и недостижимых вершин
+  std::vector<int32_t> depth;       // количество ребер от корня
+  std::vector<int32_t> xor_prefix;  // xor весов ребер на пути от корня
+};
+
+// Обход в ширину от root: order одновременно служит очередью
+inline Traversal Bfs(const Tree& tree, int32_t root) {
+  const int32_t n = tree.Size();
+  Traversal t{
+      {}, std::vector<int32_t>(n, -1), std::vector<int32_t>(n, 0), std::vector<int32_t>(n, 0)
+  };
+  t.order.reserve(n);
+  t.order.push_back(root);
+
+  for (size_t head = 0; head < t.order.size(); head++) {
+    const int32_t v = t.order[head];
+    const auto neighbors = tree.Neighbors(v);
+    const auto weights = tree.Weights(v);
+    for (size_t i = 0; i < neighbors.size(); i++) {
+      const int32_t to = neighbors[i];
+      if (to == t.parent[v]) {
+        continue;
+      }
+      t.parent[to] = v;
+      t.depth[to] = t.depth[v] + 1;
+      t.xor_prefix[to] = t.xor_prefix[v] ^ weights[i];
+      t.order.push_back(to);
+    }
+  }
+  return t;
+}
+
+// Обход в глубину от root (прямой порядок) на заранее выделенном стеке
+inline Traversal Dfs(const Tree& tree, int32_t root) {
+  const int32_t n = tree.Size();
+  Traversal t{
+      {}, std::vector<int32_t>(n, -1), std::vector<int32_t>(n, 0), std::vector<int32_t>(n, 0)
+  };
+  t.order.reserve(n);
+
+  std::vector<int32_t> stack(n);
+  size_t top = 0;
+  stack[top++] = root;
+
+  while (top > 0) {
+    const int32_t v = stack[--top];
+    t.order.push_back(v);
+
+    const auto neighbors = tree.Neighbors(v);
+    const auto weights = tree.Weights(v);
+    for (size_t i = 0; i < neighbors.size(); i++) {
+      const int32_t to = neighbors[i];
+      if (to == t.parent[v]) {
+        continue;
+      }
+      t.parent[to] = v;
+      t.depth[to] = t.depth[v] + 1;
+      t.xor_prefix[to] = t.xor_prefix[v] ^ weights[i];
+      stack[top++] = to;
+    }
+  }
+  return t;
+}
@@ -0,0 +1,67 @@
+#include "advalgo/xor_path.hpp"
+
+#include <algorithm>
+#include <utility>
+
+int32_t SolveForShop(const Tree& tree, int32_t f, uint32_t threads, bool sort_engine) {
+  const int32_t n = tree.Size() - 1;
+  // BFS to compute XOR distances from f
+  const std::vector<int32_t> val = Bfs(tree, f).xor_prefix;
+
+  // Collect all XOR-values except node f
+  std::vector<int32_t> A;
+  A.reserve(static_cast<size_t>(n - 1));
+  for (int32_t v = 1; v <= n; ++v) {
+    if (v == f) {
+      continue;
+    }
+    A.push_back(val[v]);
+  }
+
+  if (sort_engine) {
+    return SortedXorSet(std::move(A)).MaxXorPair();
+  }
+
+  // Compressed bitwise trie for max xor pair, built and queried in parallel
+  const ParallelXorTrie trie(A, threads);
+  return trie.MaxXorPair(A, threads);
+}
+
+XorPathService::XorPathService(const Tree& tree) : val_(Bfs(tree, 1).xor_prefix) {
+  const int32_t n = tree.Size() - 1;
+  for (int32_t v = 1; v <= n; v++) {
+    trie_.Insert(val_[v]);
+  }
+
+  best_ = -1;
+  for (int32_t v = 1; v <= n; v++) {
+    const int32_t cur = trie_.MaxXorWith(val_[v]);
+    if (cur > best_) {
+      best_ = cur;
+      pair_[0] = v;
+    }
+  }
+  const int32_t partner = val_[pair_[0]] ^ best_;
+  for (int32_t v = 1; v <= n; v++) {
+    if (v != pair_[0] && val_[v] == partner) {
+      pair_[1] = v;
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < pair_.size(); i++) {
+    pair_answer_[i] = MaxXorWithout(pair_[i]);
+  }
+}
+
+int32_t XorPathService::MaxXorWithout(int32_t f) {
+  trie_.Erase(val_[f]);
+  int32_t best = 0;
+  for (int32_t v = 1; v < static_cast<int32_t>(val_.size()); v++) {
+    if (v != f) {
+      best = std::max(best, trie_.MaxXorWith(val_[v]));
+    }
+  }
+  trie_.Insert(val_[f]);
+  return best;
+}
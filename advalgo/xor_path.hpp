@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "advalgo/tree.hpp"
+#include "advalgo/xor_trie.hpp"
+
+/*
+
+# Максимальный xor пути
+
+Движки задачи E поверх advalgo/xor_trie.hpp. Дерево - Tree с вершинами от 1 до n (вершина 0 не
+используется), веса ребер - до 10^9.
+
+*/
+
+// Ответ для одного магазина f: BFS от f и поиск максимального xor пары среди остальных вершин
+int32_t SolveForShop(const Tree& tree, int32_t f, uint32_t threads, bool sort_engine);
+
+// Ответы для многих магазинов по одному дереву. xor-dist(x, f) ^ xor-dist(f, y) = val[x] ^ val[y]
+// для xor-расстояний val от любого фиксированного корня, поэтому ответ для f - максимальный xor
+// пары среди всех вершин, кроме f. Лучшую пару (a, b) ищем один раз; для f не из пары ответ
+// совпадает с глобальным, а для f = a и f = b значение f удаляется из дерева и поиск повторяется
+class XorPathService {
+  std::vector<int32_t> val_;
+  BitTrie trie_;
+  int32_t best_ = 0;
+  std::array<int32_t, 2> pair_ = {0, 0};
+  std::array<int32_t, 2> pair_answer_ = {0, 0};
+
+public:
+  explicit XorPathService(const Tree& tree);
+
+  int32_t Answer(int32_t f) const {
+    for (size_t i = 0; i < pair_.size(); i++) {
+      if (pair_[i] == f) {
+        return pair_answer_[i];
+      }
+    }
+    return best_;
+  }
+
+private:
+  int32_t MaxXorWithout(int32_t f);
+};
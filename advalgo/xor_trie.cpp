@@ -0,0 +1,236 @@
+#include "advalgo/xor_trie.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+void BitTrie::Insert(int32_t x) {
+  int32_t node = 0;
+  count_[node]++;
+  for (int32_t b = MaxBit; b >= 0; --b) {
+    int32_t bit = (x >> b) & 1;
+    if (trie_[node][bit] == -1) {
+      trie_[node][bit] = static_cast<int32_t>(trie_.size());
+      trie_.push_back({-1, -1});
+      count_.push_back(0);
+    }
+    node = trie_[node][bit];
+    count_[node]++;
+  }
+}
+
+void BitTrie::Erase(int32_t x) {
+  int32_t node = 0;
+  count_[node]--;
+  for (int32_t b = MaxBit; b >= 0; --b) {
+    node = trie_[node][(x >> b) & 1];
+    count_[node]--;
+  }
+}
+
+int32_t BitTrie::MaxXorWith(int32_t x) const {
+  int32_t node = 0;
+  int32_t res = 0;
+  for (int32_t b = MaxBit; b >= 0; --b) {
+    int32_t bit = (x >> b) & 1;
+    int32_t want = bit ^ 1;
+    if (trie_[node][want] != -1 && count_[trie_[node][want]] > 0) {
+      res |= (1 << b);
+      node = trie_[node][want];
+    } else {
+      node = trie_[node][bit];
+    }
+  }
+  return res;
+}
+
+CompressedTrie::CompressedTrie(std::vector<int32_t> values) {
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  keys_.assign(values.begin(), values.end());
+
+  nodes_.reserve(keys_.size() - 1);
+  root_ = Build(0, keys_.size());
+}
+
+int32_t CompressedTrie::Build(size_t lo, size_t hi) {
+  if (hi - lo == 1) {
+    return ~static_cast<int32_t>(lo);
+  }
+
+  // Старший бит, в котором различаются значения отрезка, делит его на две части
+  const auto diff = static_cast<uint32_t>(keys_[lo] ^ keys_[hi - 1]);
+  const int32_t bit = 31 - std::countl_zero(diff);
+  const auto mid = std::partition_point(
+      keys_.begin() + static_cast<std::ptrdiff_t>(lo),
+      keys_.begin() + static_cast<std::ptrdiff_t>(hi),
+      [bit](int32_t key) { return ((key >> bit) & 1) == 0; }
+  );
+
+  const auto idx = static_cast<int32_t>(nodes_.size());
+  nodes_.push_back({bit, {-1, -1}});
+  const int32_t left = Build(lo, mid - keys_.begin());
+  const int32_t right = Build(mid - keys_.begin(), hi);
+  nodes_[idx].child = {left, right};
+  return idx;
+}
+
+SortedXorSet::SortedXorSet(std::vector<int32_t> values) : values_(std::move(values)) {
+  RadixSort(values_);
+}
+
+void SortedXorSet::RadixSort(std::vector<int32_t>& values) {
+  std::vector<int32_t> buffer(values.size());
+  std::vector<size_t> count(RadixMask + 1);
+  for (int32_t shift = 0; shift < MaxBit; shift += RadixBits) {
+    std::fill(count.begin(), count.end(), 0);
+    for (int32_t x : values) {
+      count[(static_cast<uint32_t>(x) >> shift) & RadixMask]++;
+    }
+    size_t sum = 0;
+    for (auto& c : count) {
+      sum += std::exchange(c, sum);
+    }
+    for (int32_t x : values) {
+      buffer[count[(static_cast<uint32_t>(x) >> shift) & RadixMask]++] = x;
+    }
+    values.swap(buffer);
+  }
+}
+
+size_t SortedXorSet::SplitByBit(size_t lo, size_t hi, int32_t bit) const {
+  return std::partition_point(
+             values_.begin() + static_cast<std::ptrdiff_t>(lo),
+             values_.begin() + static_cast<std::ptrdiff_t>(hi),
+             [bit](int32_t x) { return ((x >> bit) & 1) == 0; }
+         ) -
+         values_.begin();
+}
+
+int32_t SortedXorSet::Solve(size_t lo, size_t hi, int32_t bit) const {
+  for (; bit >= 0 && hi - lo > 1; bit--) {
+    const size_t mid = SplitByBit(lo, hi, bit);
+    if (mid != lo && mid != hi) {
+      return (1 << bit) | Pair(lo, mid, mid, hi, bit - 1);
+    }
+  }
+  return 0;
+}
+
+int32_t SortedXorSet::Pair(size_t a_lo, size_t a_hi, size_t b_lo, size_t b_hi, int32_t bit)
+    const {
+  if (bit < 0) {
+    return 0;
+  }
+
+  const size_t a_mid = SplitByBit(a_lo, a_hi, bit);
+  const size_t b_mid = SplitByBit(b_lo, b_hi, bit);
+  const bool a0 = a_lo < a_mid;
+  const bool a1 = a_mid < a_hi;
+  const bool b0 = b_lo < b_mid;
+  const bool b1 = b_mid < b_hi;
+
+  // Пары с противоположными битами дают единицу в текущем разряде
+  if ((a0 && b1) || (a1 && b0)) {
+    int32_t best = 0;
+    if (a0 && b1) {
+      best = std::max(best, Pair(a_lo, a_mid, b_mid, b_hi, bit - 1));
+    }
+    if (a1 && b0) {
+      best = std::max(best, Pair(a_mid, a_hi, b_lo, b_mid, bit - 1));
+    }
+    return (1 << bit) | best;
+  }
+
+  // Иначе обе половины целиком лежат по одну сторону бита
+  return a0 ? Pair(a_lo, a_mid, b_lo, b_mid, bit - 1) : Pair(a_mid, a_hi, b_mid, b_hi, bit - 1);
+}
+
+ParallelXorTrie::ParallelXorTrie(const std::vector<int32_t>& values, uint32_t threads)
+    : bucket_index_(Buckets, -1) {
+  threads = std::max<uint32_t>(threads, 1);
+  const size_t n = values.size();
+
+  // Раскладываем значения по корзинам: каждый поток считает и раскладывает свой кусок
+  std::vector<std::vector<size_t>> count(threads, std::vector<size_t>(Buckets, 0));
+  RunInThreads(threads, [&](uint32_t t) {
+    for (size_t i = n * t / threads; i < n * (t + 1) / threads; i++) {
+      count[t][values[i] >> TopShift]++;
+    }
+  });
+
+  std::vector<size_t> bucket_begin(Buckets + 1, 0);
+  size_t offset = 0;
+  for (size_t b = 0; b < Buckets; b++) {
+    bucket_begin[b] = offset;
+    for (uint32_t t = 0; t < threads; t++) {
+      offset += std::exchange(count[t][b], offset);
+    }
+  }
+  bucket_begin[Buckets] = offset;
+
+  std::vector<int32_t> scattered(n);
+  RunInThreads(threads, [&](uint32_t t) {
+    for (size_t i = n * t / threads; i < n * (t + 1) / threads; i++) {
+      scattered[count[t][values[i] >> TopShift]++] = values[i];
+    }
+  });
+
+  std::vector<int32_t> top_keys;
+  for (size_t b = 0; b < Buckets; b++) {
+    if (bucket_begin[b] < bucket_begin[b + 1]) {
+      bucket_index_[b] = static_cast<int32_t>(top_keys.size());
+      top_keys.push_back(static_cast<int32_t>(b));
+    }
+  }
+  top_.emplace(top_keys);
+
+  // Строим поддеревья непустых корзин, раздавая их потокам по очереди
+  std::vector<std::optional<CompressedTrie>> tries(top_keys.size());
+  RunInThreads(threads, [&](uint32_t t) {
+    for (size_t i = t; i < top_keys.size(); i += threads) {
+      const size_t b = top_keys[i];
+      tries[i].emplace(std::vector<int32_t>(
+          scattered.begin() + static_cast<std::ptrdiff_t>(bucket_begin[b]),
+          scattered.begin() + static_cast<std::ptrdiff_t>(bucket_begin[b + 1])
+      ));
+    }
+  });
+
+  tries_.reserve(tries.size());
+  for (auto& trie : tries) {
+    tries_.push_back(std::move(*trie));
+  }
+}
+
+int32_t ParallelXorTrie::MaxXorPair(const std::vector<int32_t>& values, uint32_t threads) const {
+  threads = std::max<uint32_t>(threads, 1);
+  const size_t n = values.size();
+
+  std::vector<int32_t> best(threads, 0);
+  RunInThreads(threads, [&](uint32_t t) {
+    int32_t local = 0;
+    for (size_t i = n * t / threads; i < n * (t + 1) / threads; i++) {
+      local = std::max(local, MaxXorWith(values[i]));
+    }
+    best[t] = local;
+  });
+
+  return *std::max_element(best.begin(), best.end());
+}
+
+size_t ParallelXorTrie::NodeCount() const {
+  size_t nodes = top_->NodeCount();
+  for (const auto& trie : tries_) {
+    nodes += trie.NodeCount();
+  }
+  return nodes;
+}
+
+size_t ParallelXorTrie::MemoryBytes() const {
+  size_t memory = top_->MemoryBytes() + bucket_index_.capacity() * sizeof(int32_t);
+  for (const auto& trie : tries_) {
+    memory += trie.MemoryBytes();
+  }
+  return memory;
+}
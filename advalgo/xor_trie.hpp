@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/*
+
+# Максимальный xor
+
+Движки поиска максимального xor для задачи E (подробное описание - в E.cpp). Значения - 31-битные
+неотрицательные числа:
+- BitTrie - обычное префиксное дерево со счетчиками, поддерживает удаление;
+- CompressedTrie - сжатое дерево только из вершин ветвления, строится сразу по всем значениям;
+- SortedXorSet - поразрядная сортировка и рекурсивное деление по битам, без дерева;
+- ParallelXorTrie - 256 независимых сжатых деревьев по старшим битам, строятся параллельно.
+
+*/
+
+constexpr int32_t MaxBit = 30;
+
+// Обычное префиксное дерево: по вершине на каждый бит каждого добавленного числа. В каждой вершине
+// хранится количество значений в поддереве, поэтому значения можно удалять
+class BitTrie {
+  std::vector<std::array<int32_t, 2>> trie_;
+  std::vector<int32_t> count_;
+
+public:
+  BitTrie() {
+    trie_.push_back({-1, -1});  // root
+    count_.push_back(0);
+  }
+
+  void Insert(int32_t x);
+
+  // Удаляет одно вхождение x, значение должно быть добавлено ранее
+  void Erase(int32_t x);
+
+  // Дерево не должно быть пустым
+  int32_t MaxXorWith(int32_t x) const;
+
+  size_t NodeCount() const {
+    return trie_.size();
+  }
+
+  size_t MemoryBytes() const {
+    return trie_.capacity() * sizeof(trie_[0]) + count_.capacity() * sizeof(int32_t);
+  }
+};
+
+// Сжатое префиксное дерево: хранит только вершины ветвления. Строится сразу по всем значениям
+class CompressedTrie {
+  // Ребенок с отрицательным индексом c - лист, соответствующий значению keys_[~c]
+  struct Node {
+    int32_t bit;
+    std::array<int32_t, 2> child;
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<int32_t> keys_;
+  int32_t root_;
+
+public:
+  // values не должен быть пустым
+  explicit CompressedTrie(std::vector<int32_t> values);
+
+  int32_t MaxXorWith(int32_t x) const {
+    int32_t node = root_;
+    while (node >= 0) {
+      const Node& cur = nodes_[node];
+      node = cur.child[((x >> cur.bit) & 1) ^ 1];
+    }
+    return x ^ keys_[~node];
+  }
+
+  size_t NodeCount() const {
+    return nodes_.size() + keys_.size();
+  }
+
+  size_t MemoryBytes() const {
+    return nodes_.capacity() * sizeof(Node) + keys_.capacity() * sizeof(int32_t);
+  }
+
+private:
+  // Строит поддерево по отрезку [lo, hi) отсортированных значений и возвращает его индекс
+  int32_t Build(size_t lo, size_t hi);
+};
+
+// Поиск максимального xor пары без префиксного дерева: значения сортируются поразрядно, после чего
+// отрезки с общим префиксом рекурсивно делятся по очередному биту на половины 0/1
+class SortedXorSet {
+  std::vector<int32_t> values_;
+
+public:
+  explicit SortedXorSet(std::vector<int32_t> values);
+
+  int32_t MaxXorPair() const {
+    return Solve(0, values_.size(), MaxBit);
+  }
+
+  size_t MemoryBytes() const {
+    return values_.capacity() * sizeof(int32_t);
+  }
+
+private:
+  static constexpr int32_t RadixBits = 15;
+  static constexpr uint32_t RadixMask = (1U << RadixBits) - 1;
+
+  // LSD сортировка по 15 бит за проход. Ключи меньше 2^30 (веса не больше 10^9, бит MaxBit всегда
+  // 0), поэтому двух проходов - по битам 0..14 и 15..29 - достаточно
+  static void RadixSort(std::vector<int32_t>& values);
+
+  // Первый индекс отрезка [lo, hi), у значения которого бит bit равен 1
+  size_t SplitByBit(size_t lo, size_t hi, int32_t bit) const;
+
+  // Максимальный xor пары внутри отрезка, значения которого совпадают в битах старше bit
+  int32_t Solve(size_t lo, size_t hi, int32_t bit) const;
+
+  // Максимальный xor пары x из [a_lo, a_hi), y из [b_lo, b_hi) по битам не старше bit
+  int32_t Pair(size_t a_lo, size_t a_hi, size_t b_lo, size_t b_hi, int32_t bit) const;
+};
+
+// Запускает fn(i) для каждого i из [0, threads): fn(0) в текущем потоке, остальные в отдельных
+template <typename Fn>
+void RunInThreads(uint32_t threads, Fn fn) {
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (uint32_t i = 1; i < threads; i++) {
+    workers.emplace_back(fn, i);
+  }
+  fn(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+// Префиксное дерево, разбитое по старшим TopBits битам на независимые сжатые поддеревья. Поддеревья
+// строятся параллельно, а над номерами непустых корзин строится маленькое дерево верхнего уровня
+class ParallelXorTrie {
+  static constexpr int32_t TopBits = 8;
+  static constexpr int32_t TopShift = MaxBit + 1 - TopBits;
+  static constexpr size_t Buckets = size_t{1} << TopBits;
+
+  std::vector<CompressedTrie> tries_;
+  std::vector<int32_t> bucket_index_;
+  std::optional<CompressedTrie> top_;
+
+public:
+  // values не должен быть пустым
+  ParallelXorTrie(const std::vector<int32_t>& values, uint32_t threads);
+
+  int32_t MaxXorWith(int32_t x) const {
+    // Старшие биты важнее младших, поэтому сначала выбираем лучшую корзину
+    const int32_t top = x >> TopShift;
+    const int32_t bucket = top ^ top_->MaxXorWith(top);
+    return tries_[bucket_index_[bucket]].MaxXorWith(x);
+  }
+
+  // Максимальный xor пары значений: запросы делятся между потоками, результаты сводятся максимумом
+  int32_t MaxXorPair(const std::vector<int32_t>& values, uint32_t threads) const;
+
+  size_t NodeCount() const;
+
+  size_t MemoryBytes() const;
+};
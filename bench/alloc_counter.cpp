@@ -0,0 +1,115 @@
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+
+# Счетчик выделений памяти
+
+Разделяемая библиотека, которую бенчмарк подгружает в процесс решения через LD_PRELOAD. Она
+подменяет malloc, calloc, realloc и функции выделения выровненной памяти, считает количество вызовов
+и запрошенные байты и передает вызов в glibc (__libc_malloc и т.д.). operator new из libstdc++
+выделяет память через malloc, поэтому тоже учитывается.
+
+При завершении процесса счетчики и пиковая память процесса пишутся строкой "allocations bytes
+peak_rss_kb" в файловый дескриптор из переменной окружения ALLOC_COUNTER_FD.
+
+*/
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> allocated_bytes{0};
+
+void Count(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+// VmHWM из /proc/self/status. rusage родителя для этого не подходит: после fork и exec в ru_maxrss
+// попадает память бенчмарка, которая была у процесса до exec
+long PeakRssKb() {
+  char status[4096];
+  const int fd = open("/proc/self/status", O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  const ssize_t length = read(fd, status, sizeof(status) - 1);
+  close(fd);
+  if (length <= 0) {
+    return 0;
+  }
+  status[length] = '\0';
+  const char* line = std::strstr(status, "VmHWM:");
+  return line != nullptr ? std::strtol(line + 6, nullptr, 10) : 0;
+}
+
+__attribute__((destructor)) void Report() {
+  const char* fd = std::getenv("ALLOC_COUNTER_FD");
+  if (fd == nullptr) {
+    return;
+  }
+  // snprintf с целыми аргументами не выделяет память
+  char line[64];
+  const int length = std::snprintf(
+      line, sizeof(line), "%zu %zu %ld\n", allocations.load(), allocated_bytes.load(), PeakRssKb()
+  );
+  if (write(std::atoi(fd), line, length) < 0) {
+    return;
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+  Count(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+  Count(count * size);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  Count(size);
+  return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+  Count(size);
+  return __libc_memalign(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+  Count(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+  Count(size);
+  *ptr = __libc_memalign(alignment, size);
+  return *ptr != nullptr ? 0 : ENOMEM;
+}
+
+void free(void* ptr) {
+  __libc_free(ptr);
+}
+
+}  // extern "C"
@@ -0,0 +1,609 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+
+# Бенчмарки
+
+Общий стенд для всех задач. Для каждой задачи есть детерминированные генераторы входа (фиксированный
+seed): случайные тесты, худшие случаи из описаний решений и тесты на максимальных ограничениях -
+например, последовательность `+ 100000`, `- 1`, `+ 1`, ... для B и деревья-пути для E и H.
+
+Решения запускаются как отдельные процессы: вход записывается во временный файл и подается на
+stdin, вывод уходит в /dev/null. Каждый тест запускается REPEAT раз, берется лучшее время. В процесс
+решения через LD_PRELOAD подгружается счетчик выделений памяти (alloc_counter.cpp), он же сообщает
+пиковую память процесса.
+
+Результат печатается в формате JSON, по одной записи на тест: время, ns на операцию, операций и
+мегабайт входа в секунду, количество выделений памяти, выделенные байты и пиковая память. Под
+операцией понимается запрос или операция из входа задачи.
+
+Аргументы:
+- `--bin-dir DIR` - каталог с собранными решениями (по умолчанию каталог самого бенчмарка);
+- `--preload PATH` - путь к liballoc_counter.so (по умолчанию в DIR);
+- `--filter STR` - запускать только тесты, в имени "задача/тест" которых есть STR;
+- `--repeat R` - количество запусков каждого теста (по умолчанию 3);
+- `--output FILE` - куда писать JSON (по умолчанию stdout).
+
+Цель `bench` в CMake собирает все решения и пишет результат в bench.json в каталоге сборки. Для
+осмысленных чисел сборка должна быть с оптимизациями (-DCMAKE_BUILD_TYPE=Release).
+
+*/
+
+struct Case {
+  std::string problem;
+  std::string name;
+  std::vector<std::string> args;
+  std::string input;
+  uint64_t ops;
+};
+
+struct Measurement {
+  double wall_ms = 1e18;
+  uint64_t allocations = 0;
+  uint64_t allocated_bytes = 0;
+  long peak_rss_kb = 0;
+  int exit_code = 0;
+};
+
+// --- Генераторы ---
+
+std::string RandomLetters(size_t length, const char* alphabet, std::mt19937& rng) {
+  const size_t size = std::char_traits<char>::length(alphabet);
+  std::string result(length, ' ');
+  for (auto& ch : result) {
+    ch = alphabet[rng() % size];
+  }
+  return result;
+}
+
+// Случайное дерево на вершинах first..first + n - 1 (родитель - случайная из предыдущих вершин)
+// или путь first - first + 1 - ... - first + n - 1
+std::vector<std::pair<uint32_t, uint32_t>> RandomTree(
+    uint32_t n,
+    uint32_t first,
+    bool path,
+    std::mt19937& rng
+) {
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  edges.reserve(n - 1);
+  for (uint32_t v = 1; v < n; v++) {
+    const uint32_t parent = path ? v - 1 : rng() % v;
+    edges.emplace_back(first + parent, first + v);
+  }
+  std::shuffle(edges.begin(), edges.end(), rng);
+  return edges;
+}
+
+// 0: t ≤ 100 строк длины ≤ 100, а также пакетный режим и запросы к подстрокам
+std::vector<Case> SquareCases() {
+  std::mt19937 rng(1);
+  std::vector<Case> cases;
+
+  std::string input = "100\n";
+  for (int32_t i = 0; i < 100; i++) {
+    const std::string half = RandomLetters(50, "ab", rng);
+    input += half + half + '\n';
+  }
+  cases.push_back({"0", "max", {}, std::move(input), 100});
+
+  auto records = [&rng](size_t count, size_t min_length, size_t max_length) {
+    std::string result;
+    for (size_t i = 0; i < count; i++) {
+      const size_t half = (min_length + rng() % (max_length - min_length + 1)) / 2;
+      std::string record = RandomLetters(half, "ab", rng);
+      record += record;
+      if (half > 0 && rng() % 2 == 0) {
+        record.back() = record.back() == 'a' ? 'b' : 'a';
+      }
+      result += record + '\n';
+    }
+    return result;
+  };
+  cases.push_back({"0", "batch_short", {"--batch", "--threads", "1"}, records(1000000, 2, 100),
+                   1000000});
+  cases.push_back({"0", "batch_long", {"--batch", "--threads", "1"},
+                   records(64, 1 << 20, 2 << 20), 64});
+
+  constexpr uint32_t N = 1000000;
+  constexpr uint32_t Q = 1000000;
+  input = RandomLetters(N, "ab", rng) + '\n' + std::to_string(Q) + '\n';
+  for (uint32_t i = 0; i < Q; i++) {
+    const uint32_t l = 1 + rng() % (N - 2000);
+    input += std::to_string(l) + ' ' + std::to_string(l + 2 * (rng() % 1000) + 1) + '\n';
+  }
+  cases.push_back({"0", "substrings", {"--substrings", "--threads", "1"}, std::move(input), Q});
+  return cases;
+}
+
+// A: N, M ≤ 2 * 10^5
+std::vector<Case> KthZeroCases() {
+  constexpr uint32_t N = 200000;
+  constexpr uint32_t M = 200000;
+
+  std::mt19937 rng(2);
+  std::vector<Case> cases;
+
+  // Случайные значения 0..3 (четверть нулей), поровну обновлений и поисков
+  std::string input = std::to_string(N) + '\n';
+  for (uint32_t i = 0; i < N; i++) {
+    input += std::to_string(rng() % 4) + ' ';
+  }
+  input += '\n' + std::to_string(M) + '\n';
+  for (uint32_t i = 0; i < M; i++) {
+    if (rng() % 2 == 0) {
+      input += "u " + std::to_string(1 + rng() % N) + ' ' + std::to_string(rng() % 4) + '\n';
+    } else {
+      uint32_t l = 1 + rng() % N;
+      uint32_t r = 1 + rng() % N;
+      if (l > r) {
+        std::swap(l, r);
+      }
+      input += "s " + std::to_string(l) + ' ' + std::to_string(r) + ' ' +
+               std::to_string(1 + rng() % (r - l + 1)) + '\n';
+    }
+  }
+  cases.push_back({"A", "random", {}, std::move(input), M});
+
+  // Худший случай для блоков: все нули, отрезки на весь массив с невыровненными границами,
+  // k-й ноль в последнем блоке - проход по всем блокам и по двум неполным блокам
+  input = std::to_string(N) + '\n';
+  for (uint32_t i = 0; i < N; i++) {
+    input += "0 ";
+  }
+  input += '\n' + std::to_string(M) + '\n';
+  for (uint32_t i = 0; i < M; i++) {
+    input += "s 2 " + std::to_string(N - 1) + ' ' + std::to_string(N - 2 - rng() % 64) + '\n';
+  }
+  cases.push_back({"A", "full_range", {}, std::move(input), M});
+
+  // Присваивания на длинных отрезках (обнуление и заполнение) вперемешку с поиском
+  input = std::to_string(N) + '\n';
+  for (uint32_t i = 0; i < N; i++) {
+    input += std::to_string(rng() % 4) + ' ';
+  }
+  input += '\n' + std::to_string(M) + '\n';
+  for (uint32_t i = 0; i < M; i++) {
+    uint32_t l = 1 + rng() % N;
+    uint32_t r = 1 + rng() % N;
+    if (l > r) {
+      std::swap(l, r);
+    }
+    if (rng() % 2 == 0) {
+      input += "a " + std::to_string(l) + ' ' + std::to_string(r) + ' ' +
+               std::to_string(rng() % 2) + '\n';
+    } else {
+      input += "s " + std::to_string(l) + ' ' + std::to_string(r) + ' ' +
+               std::to_string(1 + rng() % (r - l + 1)) + '\n';
+    }
+  }
+  cases.push_back({"A", "assign_range", {}, std::move(input), M});
+  return cases;
+}
+
+// B: n ≤ 10^5, S ≤ 10^5
+std::vector<Case> BitCounterCases() {
+  constexpr uint32_t N = 100000;
+
+  std::mt19937 rng(3);
+  std::vector<Case> cases;
+
+  // Вычитаются только ранее прибавленные степени, поэтому x остается неотрицательным
+  std::string input = std::to_string(N) + '\n';
+  std::vector<uint32_t> added;
+  for (uint32_t i = 0; i < N; i++) {
+    if (added.empty() || rng() % 3 != 0) {
+      added.push_back(rng() % 100001);
+      input += "+ " + std::to_string(added.back()) + '\n';
+    } else {
+      std::swap(added[rng() % added.size()], added.back());
+      input += "- " + std::to_string(added.back()) + '\n';
+      added.pop_back();
+    }
+  }
+  cases.push_back({"B", "random", {}, std::move(input), N});
+
+  // Худший случай из описания решения: каждое "- 1" занимает через 10^5 разрядов
+  input = std::to_string(N) + "\n+ 100000\n";
+  for (uint32_t i = 1; i < N; i++) {
+    input += i % 2 == 1 ? "- 1\n" : "+ 1\n";
+  }
+  cases.push_back({"B", "borrow_chain", {}, std::move(input), N});
+  return cases;
+}
+
+// C: n ≤ 10^6, id ≤ 10^7, score < 2^16, limit ≤ 16
+std::vector<Case> ItemFeedCases() {
+  constexpr uint32_t N = 1000000;
+
+  std::mt19937 rng(8);
+  std::vector<Case> cases;
+
+  // Ожидаемая нагрузка из условия: редкие добавления и удаления, частые обновления и очень частые
+  // запросы. Живые id хранятся в векторе, удаленный id больше не используется
+  std::vector<uint32_t> alive;
+  uint32_t next_id = 1;
+  std::string input = std::to_string(N) + '\n';
+  for (uint32_t i = 0; i < N; i++) {
+    const uint32_t kind = rng() % 100;
+    const std::string limit = std::to_string(1 + rng() % 16);
+    if (alive.size() < 1000 || kind < 5) {
+      alive.push_back(next_id);
+      next_id += 1 + rng() % 8;
+      input += "i " + std::to_string(alive.back()) + ' ' + std::to_string(1 + rng() % 65535) + '\n';
+    } else if (kind < 6) {
+      std::swap(alive[rng() % alive.size()], alive.back());
+      input += "r " + std::to_string(alive.back()) + '\n';
+      alive.pop_back();
+    } else if (kind < 26) {
+      input += "u " + std::to_string(alive[rng() % alive.size()]) + ' ' +
+               std::to_string(1 + rng() % 65535) + '\n';
+    } else if (kind < 63) {
+      input += "p " + std::to_string(rng() % alive.size()) + ' ' + limit + '\n';
+    } else {
+      input += "g " + std::to_string(alive[rng() % alive.size()]) + ' ' + limit + '\n';
+    }
+  }
+  cases.push_back({"C", "typical", {}, std::move(input), N});
+
+  // Иной паттерн нагрузки: половина операций - добавления в порядке ключа (score(id) не убывает)
+  // или с одинаковым рейтингом, вторая половина - запросы по позиции и по id
+  auto inserts_then_gets = [&rng](auto score) {
+    std::string result = std::to_string(N) + '\n';
+    for (uint32_t id = 1; id <= N / 2; id++) {
+      result += "i " + std::to_string(id) + ' ' + std::to_string(score(id)) + '\n';
+    }
+    for (uint32_t i = 0; i < N / 2; i++) {
+      const std::string limit = std::to_string(1 + rng() % 16);
+      if (i % 2 == 0) {
+        result += "p " + std::to_string(rng() % (N / 2)) + ' ' + limit + '\n';
+      } else {
+        result += "g " + std::to_string(1 + rng() % (N / 2)) + ' ' + limit + '\n';
+      }
+    }
+    return result;
+  };
+  cases.push_back({"C", "sorted_inserts", {},
+                   inserts_then_gets([](uint32_t id) { return 1 + id * 65534ULL / N; }), N});
+  cases.push_back({"C", "same_score", {}, inserts_then_gets([](uint32_t) { return 1; }), N});
+
+  // Те же входы для ленты на корзинах рейтингов; same_score - все товары в одной корзине
+  const size_t treap_cases = cases.size();
+  for (size_t i = 0; i < treap_cases; i++) {
+    cases.push_back({"C", cases[i].name + "/buckets", {"--buckets"}, cases[i].input, N});
+  }
+  return cases;
+}
+
+// D: N, R ≤ 10^5 (пока SomeArray не реализован, тест измеряет разбор входа)
+std::vector<Case> InterviewCases() {
+  constexpr uint32_t N = 100000;
+  constexpr uint32_t R = 100000;
+
+  std::mt19937 rng(4);
+  std::string input = std::to_string(N) + ' ' + std::to_string(R) + '\n';
+  for (uint32_t i = 0; i < N; i++) {
+    input += std::to_string(static_cast<int32_t>(rng() % 2000001) - 1000000) + ' ';
+  }
+  input += '\n';
+  for (uint32_t i = 0; i < R; i++) {
+    uint32_t a = 1 + rng() % N;
+    uint32_t b = 1 + rng() % N;
+    if (a > b) {
+      std::swap(a, b);
+    }
+    if (rng() % 2 == 0) {
+      b = a + ((b - a) | 1);
+      if (b > N) {
+        a -= 2;
+        b -= 2;
+      }
+      input += "1 " + std::to_string(a) + ' ' + std::to_string(b) + '\n';
+    } else {
+      input += "2 " + std::to_string(a) + ' ' + std::to_string(b) + '\n';
+    }
+  }
+  input += "0 0\n";
+  return {{"D", "max", {}, std::move(input), R}};
+}
+
+// E: n ≤ 2 * 10^5, w ≤ 10^9
+std::vector<Case> XorPathCases() {
+  constexpr uint32_t N = 200000;
+
+  std::mt19937 rng(5);
+  std::vector<Case> cases;
+  for (const bool path : {false, true}) {
+    std::string input = std::to_string(N) + ' ' + std::to_string(1 + rng() % N) + '\n';
+    for (const auto& [u, v] : RandomTree(N, 1, path, rng)) {
+      input += std::to_string(u) + ' ' + std::to_string(v) + ' ' +
+               std::to_string(1 + rng() % 1000000000) + '\n';
+    }
+    cases.push_back({"E", path ? "path" : "random", {"--threads", "1"}, std::move(input), N});
+  }
+  return cases;
+}
+
+// F: n ≤ 10^5, m ≤ 10^3, а также потоковый режим на ленте в 10^8 символов
+std::vector<Case> RibbonCases() {
+  std::mt19937 rng(6);
+  std::vector<Case> cases;
+
+  auto ribbon = [&rng](size_t n, size_t m, bool skewed) {
+    // skewed: лента из строчных букв, слова из редких заглавных - лента просматривается целиком
+    const char* alphabet = skewed ? "abcdefghijklmnopqrstuvwxyz"
+                                  : "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::string s = RandomLetters(n, alphabet, rng);
+    std::vector<std::string> words(m);
+    const size_t letters = skewed ? 8 * m : n / 64;
+    for (size_t i = 0; i < letters; i++) {
+      const char ch = static_cast<char>('A' + rng() % 26);
+      words[i % m] += ch;
+      if (skewed) {
+        s[i * (n / letters)] = ch;
+      }
+    }
+    std::string input = std::to_string(n) + ' ' + std::to_string(m) + '\n' + s + '\n';
+    for (const auto& word : words) {
+      input += word + '\n';
+    }
+    return input;
+  };
+  cases.push_back({"F", "random", {}, ribbon(100000, 1000, false), 100000});
+  cases.push_back({"F", "skewed", {}, ribbon(100000, 1000, true), 100000});
+  cases.push_back({"F", "stream", {"--stream"}, ribbon(100000000, 1000, true), 100000000});
+  return cases;
+}
+
+// H: N ≤ 10^5, Q ≤ 10^6
+std::vector<Case> TemporalCases() {
+  constexpr uint32_t N = 100000;
+  constexpr uint32_t Q = 1000000;
+
+  std::mt19937 rng(7);
+  std::vector<Case> cases;
+  for (const bool path : {false, true}) {
+    std::string input = std::to_string(N) + '\n';
+    for (const auto& [u, v] : RandomTree(N, 0, path, rng)) {
+      input += std::to_string(u) + ' ' + std::to_string(v) + '\n';
+    }
+    input += std::to_string(Q) + '\n';
+    for (uint32_t i = 0; i < Q; i++) {
+      input += std::to_string(rng() % N) + ' ' + std::to_string(rng() % N) + ' ' +
+               std::to_string(rng() % N) + '\n';
+    }
+    cases.push_back({"H", path ? "path" : "random", {"--threads", "1"}, std::move(input), Q});
+  }
+
+  // Режим --aggregate: веса ребер и операции всех видов вперемешку
+  constexpr std::array<char, 5> Ops = {'m', 'n', 's', 'x', 'q'};
+  for (const bool path : {false, true}) {
+    std::string input = std::to_string(N) + '\n';
+    for (const auto& [u, v] : RandomTree(N, 0, path, rng)) {
+      input += std::to_string(u) + ' ' + std::to_string(v) + ' ' +
+               std::to_string(rng() % 1000000000) + '\n';
+    }
+    input += std::to_string(Q) + '\n';
+    for (uint32_t i = 0; i < Q; i++) {
+      const char op = Ops[rng() % Ops.size()];
+      input += std::string(1, op) + ' ' + std::to_string(rng() % N) + ' ' +
+               std::to_string(rng() % N);
+      input += op == 'q' ? ' ' + std::to_string(rng() % N) + '\n' : "\n";
+    }
+    cases.push_back(
+        {"H", path ? "path/aggregate" : "random/aggregate", {"--aggregate"}, std::move(input), Q}
+    );
+  }
+  return cases;
+}
+
+// --- Запуск ---
+
+// Запускает binary с args, подавая на stdin файл input_fd, и ждет завершения
+Measurement RunOnce(
+    const std::string& binary,
+    const std::vector<std::string>& args,
+    int input_fd,
+    const std::string& preload
+) {
+  Measurement result;
+
+  int counter[2];
+  if (pipe(counter) != 0) {
+    std::perror("pipe");
+    std::exit(1);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const int null = open("/dev/null", O_WRONLY);
+    lseek(input_fd, 0, SEEK_SET);
+    dup2(input_fd, STDIN_FILENO);
+    dup2(null, STDOUT_FILENO);
+    close(counter[0]);
+    if (!preload.empty() && access(preload.c_str(), R_OK) == 0) {
+      setenv("LD_PRELOAD", preload.c_str(), 1);
+      setenv("ALLOC_COUNTER_FD", std::to_string(counter[1]).c_str(), 1);
+    }
+
+    std::vector<char*> argv{const_cast<char*>(binary.c_str())};
+    for (const auto& arg : args) {
+      argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    execv(binary.c_str(), argv.data());
+    std::perror(binary.c_str());
+    _exit(127);
+  }
+  close(counter[1]);
+
+  int status = 0;
+  rusage usage{};
+  wait4(pid, &status, 0, &usage);
+  const auto finish = std::chrono::steady_clock::now();
+
+  char line[64] = {};
+  const ssize_t length = read(counter[0], line, sizeof(line) - 1);
+  close(counter[0]);
+  if (length > 0) {
+    unsigned long long allocations = 0;
+    unsigned long long bytes = 0;
+    std::sscanf(line, "%llu %llu %ld", &allocations, &bytes, &result.peak_rss_kb);
+    result.allocations = allocations;
+    result.allocated_bytes = bytes;
+  } else {
+    // Без счетчика - оценка сверху: вместе с памятью бенчмарка на момент fork
+    result.peak_rss_kb = usage.ru_maxrss;
+  }
+
+  result.wall_ms = std::chrono::duration<double, std::milli>(finish - start).count();
+  result.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+  return result;
+}
+
+Measurement Run(
+    const Case& test,
+    const std::string& bin_dir,
+    const std::string& preload,
+    int32_t repeat
+) {
+  char path[] = "/tmp/advalgo-bench-XXXXXX";
+  const int fd = mkstemp(path);
+  if (fd < 0) {
+    std::perror("mkstemp");
+    std::exit(1);
+  }
+  unlink(path);
+  for (size_t written = 0; written < test.input.size();) {
+    const ssize_t chunk = write(fd, test.input.data() + written, test.input.size() - written);
+    if (chunk <= 0) {
+      std::perror("write");
+      std::exit(1);
+    }
+    written += chunk;
+  }
+
+  Measurement best;
+  for (int32_t i = 0; i < repeat; i++) {
+    const Measurement current = RunOnce(bin_dir + '/' + test.problem, test.args, fd, preload);
+    if (current.wall_ms < best.wall_ms) {
+      best = current;
+    }
+    if (current.exit_code != 0) {
+      best.exit_code = current.exit_code;
+      break;
+    }
+  }
+  close(fd);
+  return best;
+}
+
+std::string JoinArgs(const std::vector<std::string>& args) {
+  std::string result;
+  for (const auto& arg : args) {
+    result += (result.empty() ? "" : " ") + arg;
+  }
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  std::string bin_dir;
+  std::string preload;
+  std::string filter;
+  std::string output;
+  int32_t repeat = 3;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--bin-dir" && i + 1 < argc) {
+      bin_dir = argv[++i];
+    } else if (arg == "--preload" && i + 1 < argc) {
+      preload = argv[++i];
+    } else if (arg == "--filter" && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(std::atoi(argv[++i]), 1);
+    } else if (arg == "--output" && i + 1 < argc) {
+      output = argv[++i];
+    }
+  }
+  if (bin_dir.empty()) {
+    const std::string self = argv[0];
+    const size_t slash = self.rfind('/');
+    bin_dir = slash == std::string::npos ? "." : self.substr(0, slash);
+  }
+  if (preload.empty()) {
+    preload = bin_dir + "/liballoc_counter.so";
+  }
+
+  std::FILE* out = output.empty() ? stdout : std::fopen(output.c_str(), "w");
+  if (out == nullptr) {
+    std::perror(output.c_str());
+    return 1;
+  }
+
+  const std::vector<std::function<std::vector<Case>()>> generators = {
+      SquareCases, KthZeroCases, BitCounterCases, ItemFeedCases,
+      InterviewCases, XorPathCases, RibbonCases, TemporalCases,
+  };
+
+  bool first = true;
+  bool failed = false;
+  std::fprintf(out, "{\n  \"results\": [");
+  for (const auto& generate : generators) {
+    for (const Case& test : generate()) {
+      const std::string id = test.problem + '/' + test.name;
+      if (id.find(filter) == std::string::npos) {
+        continue;
+      }
+      std::fprintf(stderr, "%-16s ", id.c_str());
+
+      const Measurement m = Run(test, bin_dir, preload, repeat);
+      const double seconds = m.wall_ms / 1e3;
+      std::fprintf(stderr, "%10.2fms %10.1fns/op\n", m.wall_ms, m.wall_ms * 1e6 / test.ops);
+      failed |= m.exit_code != 0;
+
+      std::fprintf(
+          out,
+          "%s\n    {\"problem\": \"%s\", \"case\": \"%s\", \"args\": \"%s\", \"ops\": %llu, "
+          "\"input_bytes\": %zu, \"wall_ms\": %.3f, \"ns_per_op\": %.2f, \"ops_per_s\": %.1f, "
+          "\"mb_per_s\": %.2f, \"allocations\": %llu, \"allocated_bytes\": %llu, "
+          "\"peak_rss_kb\": %ld, \"exit_code\": %d}",
+          first ? "" : ",",
+          test.problem.c_str(),
+          test.name.c_str(),
+          JoinArgs(test.args).c_str(),
+          static_cast<unsigned long long>(test.ops),
+          test.input.size(),
+          m.wall_ms,
+          m.wall_ms * 1e6 / test.ops,
+          test.ops / seconds,
+          test.input.size() / seconds / 1e6,
+          static_cast<unsigned long long>(m.allocations),
+          static_cast<unsigned long long>(m.allocated_bytes),
+          m.peak_rss_kb,
+          m.exit_code
+      );
+      first = false;
+    }
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  return failed ? 1 : 0;
+}
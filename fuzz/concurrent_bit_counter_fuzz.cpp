@@ -0,0 +1,42 @@
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "advalgo/bit_counter.hpp"
+#include "advalgo/concurrent_bit_counter.hpp"
+#include "fuzz/fuzz.hpp"
+
+// ConcurrentBitCounter против BitCounter в одном потоке. S - до четырех слов, чтобы переносы и
+// заемы часто переходили через границы слов. Вычитаются только ранее прибавленные степени, поэтому
+// x остается неотрицательным
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput in(data, size);
+
+  constexpr uint32_t Bits = 320;
+  BitCounter reference(Bits);
+  ConcurrentBitCounter engine(Bits);
+  std::vector<uint32_t> added;
+  while (!in.Empty()) {
+    std::string op;
+    if (added.empty() || in.NextBool()) {
+      added.push_back(in.Next(0, 255));
+      reference.Add(added.back());
+      engine.Add(added.back());
+      op = "+ " + std::to_string(added.back());
+    } else {
+      std::swap(added[in.Next(0, static_cast<uint32_t>(added.size()) - 1)], added.back());
+      reference.Subtract(added.back());
+      engine.Subtract(added.back());
+      op = "- " + std::to_string(added.back());
+      added.pop_back();
+    }
+
+    if (engine.Ones() != reference.Ones()) {
+      FuzzFail("ConcurrentBitCounter", op + ": got " + std::to_string(engine.Ones()) +
+                                           ", expected " + std::to_string(reference.Ones()));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+
+# Драйвер фаззинга
+
+Заменяет libFuzzer для целей из fuzz/ (описание - в fuzz.hpp). Без аргументов-файлов прогоняет RUNS
+случайных входов: вход номер i порождается генератором с seed SEED + i, длина - до MAX_LEN байт.
+Если цель падает, вход записывается в файл crash-<seed> в текущем каталоге, и его можно повторить,
+передав файл аргументом.
+
+Аргументы:
+- `--runs RUNS` - количество случайных входов (по умолчанию 10000);
+- `--seed SEED` - seed первого входа (по умолчанию 1);
+- `--max-len MAX_LEN` - максимальная длина входа (по умолчанию 4096);
+- остальные аргументы - файлы, каждый из которых подается на вход один раз.
+
+*/
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+// Текущий вход: обработчик сигнала сохраняет его на диск
+const std::vector<uint8_t>* current_input = nullptr;
+char crash_path[64] = "crash";
+
+void SaveCrash(int signal) {
+  if (current_input != nullptr) {
+    const int fd = open(crash_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+      [[maybe_unused]] const ssize_t written =
+          write(fd, current_input->data(), current_input->size());
+      close(fd);
+    }
+    const char message[] = "input saved to ";
+    [[maybe_unused]] ssize_t written = write(STDERR_FILENO, message, sizeof(message) - 1);
+    written = write(STDERR_FILENO, crash_path, std::strlen(crash_path));
+    written = write(STDERR_FILENO, "\n", 1);
+  }
+  std::signal(signal, SIG_DFL);
+  std::raise(signal);
+}
+
+bool ReadFile(const char* path, std::vector<uint8_t>& data) {
+  std::FILE* file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    std::perror(path);
+    return false;
+  }
+  data.clear();
+  uint8_t buffer[1 << 16];
+  size_t read = 0;
+  while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + read);
+  }
+  std::fclose(file);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint64_t runs = 10000;
+  uint64_t seed = 1;
+  size_t max_len = 4096;
+  std::vector<const char*> files;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--runs" && i + 1 < argc) {
+      runs = std::stoull(argv[++i]);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      seed = std::stoull(argv[++i]);
+    } else if (arg == "--max-len" && i + 1 < argc) {
+      max_len = std::stoull(argv[++i]);
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+
+  std::signal(SIGABRT, SaveCrash);
+  std::signal(SIGSEGV, SaveCrash);
+
+  std::vector<uint8_t> input;
+  current_input = &input;
+
+  if (!files.empty()) {
+    for (const char* path : files) {
+      if (!ReadFile(path, input)) {
+        return 1;
+      }
+      std::snprintf(crash_path, sizeof(crash_path), "crash-file");
+      LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    std::printf("%zu files: ok\n", files.size());
+    return 0;
+  }
+
+  for (uint64_t run = 0; run < runs; run++) {
+    std::mt19937_64 rng(seed + run);
+    input.resize(rng() % (max_len + 1));
+    for (auto& byte : input) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    std::snprintf(crash_path, sizeof(crash_path), "crash-%llu",
+                  static_cast<unsigned long long>(seed + run));
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  std::printf("%llu runs: ok\n", static_cast<unsigned long long>(runs));
+  return 0;
+}
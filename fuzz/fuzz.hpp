@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/*
+
+# Дифференциальный фаззинг
+
+Каждая цель фаззинга (fuzz/<движок>_fuzz.cpp) превращает байты входа в поток операций, применяет
+его к оптимизированному движку из advalgo/ и к наивной эталонной реализации и сравнивает все
+ответы. При расхождении печатается операция и оба ответа, после чего процесс падает через abort.
+
+Цели реализуют точку входа libFuzzer - LLVMFuzzerTestOneInput. Собираются двумя способами:
+- по умолчанию со своим драйвером (driver.cpp), которому не нужен libFuzzer: он подает на вход
+  случайные байты с фиксированным seed или содержимое файлов, переданных аргументами;
+- с опцией CMake `-DADVALGO_LIBFUZZER=ON` (только Clang) - как обычные цели libFuzzer с
+  AddressSanitizer.
+
+Цель `fuzz` в CMake собирает все цели и прогоняет каждую драйвером.
+
+*/
+
+// Читает из байтов входа числа в заданных пределах. Когда байты кончаются, возвращает нижнюю
+// границу, поэтому любой вход превращается в корректный поток операций
+class FuzzInput {
+  const uint8_t* data_;
+  size_t size_;
+
+public:
+  FuzzInput(const uint8_t* data, size_t size) : data_(data), size_(size) {
+  }
+
+  bool Empty() const {
+    return size_ == 0;
+  }
+
+  // Число из [lo, hi]; для узких диапазонов тратит один байт, иначе до четырех
+  uint32_t Next(uint32_t lo, uint32_t hi) {
+    const uint64_t range = uint64_t{hi} - lo + 1;
+    uint64_t value = 0;
+    for (uint64_t covered = 1; covered < range && size_ > 0; covered <<= 8) {
+      value = (value << 8) | *data_;
+      data_++;
+      size_--;
+    }
+    return lo + static_cast<uint32_t>(value % range);
+  }
+
+  bool NextBool() {
+    return Next(0, 1) == 1;
+  }
+};
+
+// Сообщает о расхождении движка с эталоном и роняет процесс
+[[noreturn]] inline void FuzzFail(const char* engine, const std::string& detail) {
+  std::fprintf(stderr, "%s: mismatch: %s\n", engine, detail.c_str());
+  std::abort();
+}
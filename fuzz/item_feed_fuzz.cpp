@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "advalgo/bucket_item_feed.hpp"
+#include "advalgo/indexed_item_feed.hpp"
+#include "advalgo/item_feed.hpp"
+#include "fuzz/fuzz.hpp"
+
+// ItemFeed против std::set пар (score, id). Идентификаторов и рейтингов мало, поэтому часто
+// встречаются одинаковые рейтинги, обновления уже удаленных и снова добавленных товаров и длинные
+// цепочки Successor через родителей. IndexedItemFeed проверяется на том же потоке операций с
+// маленьким порогом затишья, чтобы журнал вливался в слой чтения между почти любыми изменениями, а
+// BucketItemFeed - с кусками по 2-8 id, чтобы при рейтингах до 4 корзины делились на много кусков
+
+namespace {
+
+using youndex::express::BucketItemFeed;
+using youndex::express::IndexedItemFeed;
+using youndex::express::Item;
+using youndex::express::ItemFeed;
+
+class ReferenceFeed {
+  std::set<std::pair<uint16_t, uint64_t>> order_;
+  std::unordered_map<uint64_t, uint16_t> score_;
+
+public:
+  size_t Size() const {
+    return order_.size();
+  }
+
+  bool Contains(uint64_t id) const {
+    return score_.count(id) > 0;
+  }
+
+  void Add(Item item) {
+    order_.emplace(item.score, item.id);
+    score_[item.id] = item.score;
+  }
+
+  void Remove(uint64_t id) {
+    order_.erase({score_.at(id), id});
+    score_.erase(id);
+  }
+
+  std::vector<uint64_t> GetAtPosition(size_t position, size_t limit) const {
+    return Page(std::next(order_.begin(), static_cast<std::ptrdiff_t>(position)), limit);
+  }
+
+  std::vector<uint64_t> GetAtItemWithId(uint64_t id, size_t limit) const {
+    return Page(order_.find({score_.at(id), id}), limit);
+  }
+
+private:
+  using Iterator = std::set<std::pair<uint16_t, uint64_t>>::const_iterator;
+
+  std::vector<uint64_t> Page(Iterator it, size_t limit) const {
+    std::vector<uint64_t> result;
+    for (; it != order_.end() && result.size() < limit; ++it) {
+      result.push_back(it->second);
+    }
+    return result;
+  }
+};
+
+std::string Join(const std::vector<uint64_t>& ids) {
+  std::string result = "[";
+  for (const uint64_t id : ids) {
+    result += std::to_string(id) + ", ";
+  }
+  return result + ']';
+}
+
+void Compare(
+    const std::string& op,
+    const std::vector<uint64_t>& actual,
+    const std::vector<uint64_t>& expected
+) {
+  if (actual != expected) {
+    FuzzFail("ItemFeed", op + ": got " + Join(actual) + ", expected " + Join(expected));
+  }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput in(data, size);
+
+  const uint32_t max_id = in.Next(1, 64);
+  // Рейтинг 1 у всех товаров - худший случай для корзин: все id в одной корзине
+  constexpr uint32_t MaxScores[] = {1, 4, 65535};
+  const uint32_t max_score = MaxScores[in.Next(0, 2)];
+
+  ItemFeed engine;
+  IndexedItemFeed indexed(in.Next(1, 4));
+  BucketItemFeed buckets(in.Next(2, 8));
+  ReferenceFeed reference;
+  while (!in.Empty()) {
+    const uint32_t op = in.Next(0, 3);
+    const auto id = uint64_t{in.Next(1, max_id)};
+    const auto score = static_cast<uint16_t>(in.Next(1, max_score));
+
+    if (op == 0 || !reference.Contains(id)) {
+      if (!reference.Contains(id)) {
+        engine.Add({id, score});
+        indexed.Add({id, score});
+        buckets.Add({id, score});
+        reference.Add({id, score});
+      }
+    } else if (op == 1) {
+      engine.Update({id, score});
+      indexed.Update({id, score});
+      buckets.Update({id, score});
+      reference.Remove(id);
+      reference.Add({id, score});
+    } else if (op == 2) {
+      engine.Remove(id);
+      indexed.Remove(id);
+      buckets.Remove(id);
+      reference.Remove(id);
+    } else {
+      const auto limit = size_t{in.Next(1, 16)};
+      const std::string suffix = ' ' + std::to_string(limit);
+      const std::vector<uint64_t> by_id = reference.GetAtItemWithId(id, limit);
+      Compare("g " + std::to_string(id) + suffix, engine.GetAtItemWithId(id, limit), by_id);
+      Compare("indexed g " + std::to_string(id) + suffix, indexed.GetAtItemWithId(id, limit),
+              by_id);
+      Compare("buckets g " + std::to_string(id) + suffix, buckets.GetAtItemWithId(id, limit),
+              by_id);
+
+      const auto position = size_t{in.Next(0, reference.Size() - 1)};
+      const std::vector<uint64_t> by_position = reference.GetAtPosition(position, limit);
+      Compare("p " + std::to_string(position) + suffix, engine.GetAtPosition(position, limit),
+              by_position);
+      Compare("indexed p " + std::to_string(position) + suffix,
+              indexed.GetAtPosition(position, limit), by_position);
+      Compare("buckets p " + std::to_string(position) + suffix,
+              buckets.GetAtPosition(position, limit), by_position);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "advalgo/lca.hpp"
+#include "advalgo/tree.hpp"
+#include "fuzz/fuzz.hpp"
+
+// LcaTable с агрегатами против прохода по пути через родителей. Дерево - от 2 до 300 вершин,
+// каждая подвешивается к одной из предыдущих: к случайной или к одной из ближайших, чтобы
+// получались и широкие, и глубокие деревья (подъемы на 2^k для больших k). Номера вершин
+// перемешиваются. В половине входов веса не больше 3, чтобы максимум и минимум на пути часто
+// повторялись
+
+namespace {
+
+struct Naive {
+  std::vector<int32_t> parent;
+  std::vector<int32_t> depth;
+  std::vector<int32_t> weight;  // вес ребра в родителя
+
+  PathAggregate Walk(int32_t a, int32_t b) const {
+    PathAggregate path;
+    auto step = [&](int32_t& v) {
+      path.max_weight = path.edges == 0 ? weight[v] : std::max(path.max_weight, weight[v]);
+      path.min_weight = path.edges == 0 ? weight[v] : std::min(path.min_weight, weight[v]);
+      path.sum += weight[v];
+      path.xor_sum ^= weight[v];
+      path.edges++;
+      v = parent[v];
+    };
+    while (depth[a] > depth[b]) {
+      step(a);
+    }
+    while (depth[b] > depth[a]) {
+      step(b);
+    }
+    while (a != b) {
+      step(a);
+      step(b);
+    }
+    return path;
+  }
+};
+
+std::string Describe(const PathAggregate& path) {
+  return std::to_string(path.edges) + ' ' + std::to_string(path.max_weight) + ' ' +
+         std::to_string(path.min_weight) + ' ' + std::to_string(path.sum) + ' ' +
+         std::to_string(path.xor_sum);
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput in(data, size);
+
+  // Хотя бы две вершины: иначе запросы не тратят байты входа
+  const int32_t n = static_cast<int32_t>(in.Next(2, 300));
+  const bool deep = in.NextBool();
+  const uint32_t max_weight = in.NextBool() ? 3 : 0x7FFFFFFF;
+
+  // Вершина i исходного порядка получает номер label[i], корень 0 остается на месте
+  std::vector<int32_t> label(n);
+  for (int32_t i = 0; i < n; i++) {
+    label[i] = i;
+  }
+  for (int32_t i = n - 1; i > 1; i--) {
+    std::swap(label[i], label[static_cast<int32_t>(in.Next(1, i))]);
+  }
+
+  Naive naive{std::vector<int32_t>(n, -1), std::vector<int32_t>(n, 0), std::vector<int32_t>(n, 0)};
+  std::vector<Edge> edges;
+  for (int32_t i = 1; i < n; i++) {
+    const auto back = static_cast<int32_t>(deep ? in.Next(1, std::min(i, 2)) : in.Next(1, i));
+    const int32_t u = label[i - back];
+    const int32_t v = label[i];
+    const auto w = static_cast<int32_t>(in.Next(0, max_weight));
+    naive.parent[v] = u;
+    naive.depth[v] = naive.depth[u] + 1;
+    naive.weight[v] = w;
+    edges.push_back(in.NextBool() ? Edge{u, v, w} : Edge{v, u, w});
+  }
+
+  const LcaTable table(Tree(n, edges), true);
+  while (!in.Empty()) {
+    const auto u = static_cast<int32_t>(in.Next(0, n - 1));
+    const auto v = static_cast<int32_t>(in.Next(0, n - 1));
+    const std::string query = "n=" + std::to_string(n) + " path " + std::to_string(u) + ' ' +
+                              std::to_string(v);
+
+    const PathAggregate expected = naive.Walk(u, v);
+    const PathAggregate actual = table.Aggregate(u, v);
+    if (actual.edges != expected.edges || actual.max_weight != expected.max_weight ||
+        actual.min_weight != expected.min_weight || actual.sum != expected.sum ||
+        actual.xor_sum != expected.xor_sum) {
+      FuzzFail("LcaTable", query + ": got " + Describe(actual) + ", expected " +
+                               Describe(expected));
+    }
+    if (table.Distance(u, v) != expected.edges || table.PathXor(u, v) != expected.xor_sum) {
+      FuzzFail("LcaTable", query + ": distance " + std::to_string(table.Distance(u, v)) +
+                               ", xor " + std::to_string(table.PathXor(u, v)) + ", expected " +
+                               Describe(expected));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "advalgo/persistent_zero_tree.hpp"
+#include "fuzz/fuzz.hpp"
+
+// PersistentZeroTree против копий массива после каждого обновления. Запросы идут и к последней
+// версии, и к любой из прошлых, и к паре еще не созданных - для них ответ -1
+
+namespace {
+
+int32_t KthZero(const std::vector<uint32_t>& array, uint32_t left, uint32_t right, uint32_t k) {
+  uint32_t count = 0;
+  for (uint32_t i = left; i <= right && i <= array.size(); i++) {
+    if (array[i - 1] == 0 && ++count == k) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput in(data, size);
+
+  const uint32_t n = in.Next(1, 300);
+  std::vector<uint32_t> array(n);
+  for (auto& value : array) {
+    value = in.Next(0, 2);
+  }
+
+  PersistentZeroTree engine(array);
+  std::vector<std::vector<uint32_t>> history = {array};
+  while (!in.Empty()) {
+    if (in.NextBool()) {
+      const uint32_t index = in.Next(1, n);
+      const uint32_t value = in.Next(0, 2);
+      array[index - 1] = value;
+      history.push_back(array);
+      const uint32_t version = engine.Update(index, value);
+      if (version != history.size() - 1) {
+        FuzzFail("PersistentZeroTree", "version " + std::to_string(version) + ", expected " +
+                                           std::to_string(history.size() - 1));
+      }
+      continue;
+    }
+
+    const uint32_t version = in.Next(0, static_cast<uint32_t>(history.size() + 1));
+    const uint32_t left = in.Next(1, n);
+    const uint32_t right = in.Next(1, n);
+    const uint32_t k = in.Next(1, n);
+    const int32_t expected =
+        version < history.size() ? KthZero(history[version], left, right, k) : -1;
+    const int32_t actual = engine.Search(version, left, right, k);
+    if (actual != expected) {
+      FuzzFail("PersistentZeroTree", "n=" + std::to_string(n) + " h " + std::to_string(version) +
+                                         ' ' + std::to_string(left) + ' ' + std::to_string(right) +
+                                         ' ' + std::to_string(k) + ": got " +
+                                         std::to_string(actual) + ", expected " +
+                                         std::to_string(expected));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "advalgo/ribbon.hpp"
+#include "fuzz/fuzz.hpp"
+
+// Все сопоставители ленты против проверки, записанной прямо по условию. Лента - до 300 букв из
+// маленького алфавита (чтобы ответ часто был YES) или из всех 52 букв, длиннее блока AVX-512.
+// RibbonIndex и StreamMatcher получают ленту случайными кусками
+
+namespace {
+
+constexpr std::string_view Letters = "abABcdefghijklmnopqrstuvwxyzCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// Слово words[j] выбирается как подпоследовательность s[pos, ...) с самым ранним концом, следующее
+// слово начинается не раньше чем через одну букву после него
+bool Reference(std::string_view s, const std::vector<std::string>& words, size_t j, size_t pos) {
+  if (j == words.size()) {
+    return true;
+  }
+  size_t matched = 0;
+  for (; pos < s.size(); pos++) {
+    if (s[pos] == words[j][matched] && ++matched == words[j].size()) {
+      return Reference(s, words, j + 1, pos + 2);
+    }
+  }
+  return false;
+}
+
+std::vector<size_t> RandomCuts(FuzzInput& in, size_t size) {
+  std::vector<size_t> cuts = {0};
+  while (cuts.back() < size) {
+    // Пустые куски тоже допустимы; когда вход кончился, остаток ленты идет одним куском
+    const auto rest = static_cast<uint32_t>(size - cuts.back());
+    cuts.push_back(cuts.back() + (in.Empty() ? rest : in.Next(0, rest)));
+  }
+  return cuts;
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput in(data, size);
+
+  const uint32_t alphabet = in.NextBool() ? in.Next(1, 4) : Letters.size();
+  const uint32_t n = in.Next(1, 300);
+  const uint32_t m = in.Next(1, 8);
+
+  std::string s(n, ' ');
+  for (auto& ch : s) {
+    ch = Letters[in.Next(0, alphabet - 1)];
+  }
+  std::vector<std::string> words(m);
+  std::string text;
+  for (auto& word : words) {
+    word.resize(in.Next(1, 1 + n / m));
+    for (auto& ch : word) {
+      ch = Letters[in.Next(0, alphabet - 1)];
+    }
+    text += word + ' ';
+  }
+
+  const bool expected = Reference(s, words, 0, 0);
+  auto check = [&](const char* engine, bool actual) {
+    if (actual != expected) {
+      FuzzFail(engine, "s=" + s + " words=" + text + "got " + (actual ? "YES" : "NO"));
+    }
+  };
+
+  check("MatchesGreedy", MatchesGreedy(s, words));
+  check("MatchesScan", MatchesScan(s, words));
+
+  auto with = [](FindByteFn find) {
+    return [find](std::string_view r, size_t pos, char c) {
+      return pos < r.size() ? find(r.data(), r.size(), pos, c) : ByteNotFound;
+    };
+  };
+  check("FindByteScalar", MatchesScan(s, words, with(FindByteScalar)));
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  check("FindByteSse2", MatchesScan(s, words, with(FindByteSse2)));
+  if (__builtin_cpu_supports("avx2")) {
+    check("FindByteAvx2", MatchesScan(s, words, with(FindByteAvx2)));
+  }
+  if (__builtin_cpu_supports("avx512bw")) {
+    check("FindByteAvx512", MatchesScan(s, words, with(FindByteAvx512)));
+  }
+#endif
+
+  const std::vector<size_t> cuts = RandomCuts(in, s.size());
+  const std::string_view ribbon = s;
+
+  RibbonIndex index;
+  for (size_t i = 1; i < cuts.size(); i++) {
+    index.Append(ribbon.substr(cuts[i - 1], cuts[i] - cuts[i - 1]));
+  }
+  check("RibbonIndex", index.Matches(words));
+
+  MemoryWords source(text, words.size());
+  StreamMatcher matcher(source);
+  for (size_t i = 1; i < cuts.size() && !matcher.Done(); i++) {
+    matcher.Feed(ribbon.substr(cuts[i - 1], cuts[i] - cuts[i - 1]));
+  }
+  check("StreamMatcher", matcher.Done());
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "advalgo/segmented_array.hpp"
+#include "fuzz/fuzz.hpp"
+
+// SegmentedArray против прохода по массиву. Длина массива - до пяти блоков, значения в основном
+// нули и единицы, чтобы границы отрезков часто попадали внутрь блоков с нужным нулем. Присваивания
+// на отрезках перемежаются с точечными обновлениями, чтобы проверить снятие ленивых пометок, а в
+// режиме keep_values значения проверяются и через Value (в том числе после расширения
+// NarrowValues). Для k до 3 с эталоном сравниваются и ядра FindFirstZero / FindKthZero<K>
+
+namespace {
+
+int32_t KthZero(const std::vector<uint32_t>& array, uint32_t left, uint32_t right, uint32_t k) {
+  uint32_t count = 0;
+  for (uint32_t i = left; i <= right && i <= array.size(); i++) {
+    if (array[i - 1] == 0 && ++count == k) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  FuzzInput in(data, size);
+
+  const uint32_t n = in.Next(1, 5 << BlockSizeShift);
+  const uint32_t max_value = in.NextBool() ? 1 : 100000;
+  std::vector<uint32_t> array(n);
+  for (auto& value : array) {
+    value = in.Next(0, max_value);
+  }
+
+  const bool keep_values = in.NextBool();
+  SegmentedArray engine(array, keep_values);
+  while (!in.Empty()) {
+    const uint32_t op = in.Next(0, 4);
+    if (op == 0) {
+      const uint32_t index = in.Next(1, n);
+      const uint32_t value = in.Next(0, max_value);
+      engine.Update(index, value);
+      array[index - 1] = value;
+      continue;
+    }
+    if (op == 1) {
+      const uint32_t left = in.Next(1, n);
+      const uint32_t right = in.Next(1, n);
+      const uint32_t value = in.Next(0, max_value);
+      engine.AssignRange(left, right, value);
+      for (uint32_t i = left; i <= right; i++) {
+        array[i - 1] = value;
+      }
+      continue;
+    }
+    if (op == 2 && keep_values) {
+      const uint32_t index = in.Next(1, n);
+      if (engine.Value(index) != array[index - 1]) {
+        FuzzFail("SegmentedArray", "n=" + std::to_string(n) + " value " + std::to_string(index) +
+                                       ": got " + std::to_string(engine.Value(index)) +
+                                       ", expected " + std::to_string(array[index - 1]));
+      }
+      continue;
+    }
+
+    const uint32_t left = in.Next(1, n);
+    const uint32_t right = in.Next(1, n);
+    const uint32_t k = in.NextBool() ? in.Next(1, 3) : in.Next(1, n);
+    const int32_t expected = KthZero(array, left, right, k);
+    const std::string query = "n=" + std::to_string(n) + " s " + std::to_string(left) + ' ' +
+                              std::to_string(right) + ' ' + std::to_string(k);
+    const int32_t actual = engine.Search(left, right, k);
+    if (actual != expected) {
+      FuzzFail("SegmentedArray", query + ": got " + std::to_string(actual) + ", expected " +
+                                     std::to_string(expected));
+    }
+
+    if (k > 3) {
+      continue;
+    }
+    const int32_t kernel = k == 1   ? engine.FindFirstZero(left, right)
+                           : k == 2 ? engine.FindKthZero<2>(left, right)
+                                    : engine.FindKthZero<3>(left, right);
+    if (kernel != expected) {
+      FuzzFail("FindKthZero", query + ": got " + std::to_string(kernel) + ", expected " +
+                                  std::to_string(expected));
+    }
+  }
+  return 0;
+}